@@ -15,42 +15,194 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <errno.h>
 #include "assert.h"
 #include "compress40.h"
+#include "batch40.h"
+#include "word_layout.h"
 
-static void (*compress_or_decompress)(FILE *input) = compress40;
+/* the most threads -j can ask for */
+#define MAX_THREADS 1024
+
+static void usage(char *program);
+static void choose_direction(bool *compress, bool *chosen, bool value, 
+                             char *program);
+static void choose_format(const char **format, const char *flag, 
+                          char *program);
 
 int main(int argc, char *argv[])
 {
         int i;
+        bool compress = true;
+        bool direction_chosen = false;
+        const char *format = NULL;
+        char *list = NULL;
+        struct arith40_region region;
+        struct arith40_options options = ARITH40_DEFAULT_OPTIONS;
 
         for (i = 1; i < argc; i++) {
                 if (strcmp(argv[i], "-c") == 0) {
-                        compress_or_decompress = compress40;
+                        choose_direction(&compress, &direction_chosen, true,
+                                         argv[0]);
                 } else if (strcmp(argv[i], "-d") == 0) {
-                        compress_or_decompress = decompress40;
+                        choose_direction(&compress, &direction_chosen, false,
+                                         argv[0]);
+                } else if (strcmp(argv[i], "-s") == 0) {
+                        choose_direction(&compress, &direction_chosen, true,
+                                         argv[0]);
+                        choose_format(&format, argv[i], argv[0]);
+                        options.stream = true;
+                } else if (strcmp(argv[i], "-t") == 0) {
+                        choose_direction(&compress, &direction_chosen, true,
+                                         argv[0]);
+                        choose_format(&format, argv[i], argv[0]);
+                        options.tiled = true;
+                } else if (strcmp(argv[i], "-e") == 0) {
+                        choose_direction(&compress, &direction_chosen, true,
+                                         argv[0]);
+                        choose_format(&format, argv[i], argv[0]);
+                        options.entropy = true;
+                } else if (strcmp(argv[i], "-p") == 0) {
+                        choose_direction(&compress, &direction_chosen, true,
+                                         argv[0]);
+                        choose_format(&format, argv[i], argv[0]);
+                        options.progressive = true;
+                } else if (strcmp(argv[i], "-f") == 0) {
+                        /* compress to the fine layout, format 7 */
+                        choose_direction(&compress, &direction_chosen, true,
+                                         argv[0]);
+                        choose_format(&format, argv[i], argv[0]);
+                        options.layout = &fine_layout;
+                } else if (strcmp(argv[i], "-a") == 0) {
+                        options.async = true;
+                } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+                        int end = 0;
+                        sscanf(argv[++i], "%u,%u,%u,%u%n", &region.x, 
+                               &region.y, &region.width, &region.height, 
+                               &end);
+                        if (end == 0 || argv[i][end] != '\0') {
+                                fprintf(stderr, "%s: bad region '%s'\n",
+                                        argv[0], argv[i]);
+                                exit(1);
+                        }
+                        choose_direction(&compress, &direction_chosen, 
+                                         false, argv[0]);
+                        options.region = &region;
+                } else if (strcmp(argv[i], "-h") == 0) {
+                        /* decompress a half size thumbnail */
+                        choose_direction(&compress, &direction_chosen, 
+                                         false, argv[0]);
+                        options.thumbnail = true;
+                } else if (strcmp(argv[i], "-8") == 0) {
+                        /* decompress to one byte per sample */
+                        options.maxval = 255;
+                } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                        char *end;
+                        errno = 0;
+                        long n = strtol(argv[++i], &end, 10);
+                        if (end == argv[i] || *end != '\0' || errno != 0 ||
+                            n < 1 || n > MAX_THREADS) {
+                                fprintf(stderr, "%s: bad thread count '%s'\n",
+                                        argv[0], argv[i]);
+                                exit(1);
+                        }
+                        options.threads = n;
+                } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+                        list = argv[++i];
                 } else if (*argv[i] == '-') {
                         fprintf(stderr, "%s: unknown option '%s'\n",
                                 argv[0], argv[i]);
                         exit(1);
-                } else if (argc - i > 2) {
-                        fprintf(stderr, "Usage: %s -d [filename]\n"
-                                "       %s -c [filename]\n",
-                                argv[0], argv[0]);
-                        exit(1);
+                } else if (argc - i > 2 || list != NULL) {
+                        usage(argv[0]);
                 } else {
                         break;
                 }
         }
         assert(argc - i <= 1);    /* at most one file on command line */
+
+        /* a thumbnail is never a region, and -8 only sets how to decompress */
+        if ((options.thumbnail && options.region != NULL) || 
+            (compress && options.maxval != 0)) {
+                usage(argv[0]);
+        }
+
+        if (list != NULL) {
+                /* -j is the number of images done at once */
+                FILE *fp = strcmp(list, "-") == 0 ? stdin : fopen(list, "r");
+                assert(fp != NULL);
+                int failures = batch40(fp, compress, &options);
+                if (fp != stdin) {
+                        fclose(fp);
+                }
+                return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        FILE *fp = stdin;
         if (i < argc) {
-                FILE *fp = fopen(argv[i], "r");
+                fp = fopen(argv[i], "r");
                 assert(fp != NULL);
-                compress_or_decompress(fp);
-                fclose(fp);
+        }
+        if (compress) {
+                compress40_with(fp, stdout, &options);
         } else {
-                compress_or_decompress(stdin);
+                decompress40_with(fp, stdout, &options);
+        }
+        if (fp != stdin) {
+                fclose(fp);
+        }
+        if (ferror(stdout) | fflush(stdout)) {
+                fprintf(stderr, "%s: cannot write\n", argv[0]);
+                return EXIT_FAILURE;
         }
 
         return EXIT_SUCCESS; 
 }
+
+
+/* prints how to run 40image, then exits */
+static void usage(char *program)
+{
+        fprintf(stderr, "Usage: %s -d [-a] [-8] [-j threads] [filename]\n"
+                "       %s -r x,y,width,height [-a] [-8] [filename]\n"
+                "       %s -h [-a] [-8] [filename]\n"
+                "       %s -c [-a] [-j threads] [filename]\n"
+                "       %s -s [-a] [filename]\n"
+                "       %s -t [-a] [-j threads] [filename]\n"
+                "       %s -e [-a] [-j threads] [filename]\n"
+                "       %s -p [-a] [-j threads] [filename]\n"
+                "       %s -f [-a] [filename]\n"
+                "       %s -c|-d|-e|-f|-h|-p|-s|-t -b listfile [-a] [-8] "
+                "[-j threads]\n",
+                program, program, program, program, program, program, 
+                program, program, program, program);
+        exit(1);
+}
+
+/* 
+ * sets whether to compress or decompress, or prints how to run 40image and
+ * exits if a flag before chose the other
+ */
+static void choose_direction(bool *compress, bool *chosen, bool value, 
+                             char *program)
+{
+        if (*chosen && *compress != value) {
+                usage(program);
+        }
+        *compress = value;
+        *chosen = true;
+}
+
+/* 
+ * sets the format to compress to, or prints how to run 40image and exits 
+ * if a flag before chose another
+ */
+static void choose_format(const char **format, const char *flag, 
+                          char *program)
+{
+        if (*format != NULL && strcmp(*format, flag) != 0) {
+                usage(program);
+        }
+        *format = flag;
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+*       arena40.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the implementation of an arena. Memory comes from
+*       a list of chunks, newest first, and allocating only moves an offset
+*       into the newest one. Disposing the arena frees every chunk.
+*   
+******************************************************************************/
+
+#include <stdlib.h>
+#include "assert.h"
+#include "arena40.h"
+
+#define T Arena40_T
+
+/* the smallest chunk, in bytes, that an arena mallocs */
+#define MIN_CHUNK_LENGTH (64 * 1024)
+
+/* every allocation is rounded up to a multiple of the size of this union */
+union align {
+        long l;
+        double d;
+        long double ld;
+        void *p;
+        void (*f)(void);
+};
+
+/* 
+ * struct chunk
+ *      A struct that heads a chunk of memory: the next (older) chunk, the 
+ *      number of bytes after the header, and how many of them are in use.
+ *      The union keeps the bytes after the header aligned.
+ */
+struct chunk {
+        union {
+                struct {
+                        struct chunk *next;
+                        size_t length;
+                        size_t used;
+                } head;
+                union align align;
+        } u;
+};
+
+struct T {
+        struct chunk *chunks;
+};
+
+/******** HELPER FUNCTIONS ********/
+struct chunk *new_chunk(size_t length, struct chunk *next);
+void free_chunks(struct chunk *chunk);
+
+
+/*
+*       Description: A function that creates an empty arena.
+*
+*       In/Out Expectations: Mallocs space for the arena, which must be 
+*       freed by the client with Arena40_dispose. Returns the arena.
+*/
+T Arena40_new(void) {
+        T arena = malloc(sizeof(*arena));
+        assert(arena != NULL);
+
+        arena->chunks = NULL;
+        return arena;
+}
+
+/*
+*       Description: Frees an arena and every chunk it holds.
+*
+*       In/Out Expectations: expects a pointer to an arena made by 
+*       Arena40_new. Sets the pointer to NULL. Returns void.
+*/
+void Arena40_dispose(T *arena) {
+        assert(arena != NULL && *arena != NULL);
+
+        free_chunks((*arena)->chunks);
+        free(*arena);
+        *arena = NULL;
+}
+
+/*
+*       Description: A function that allocates memory in an arena, from the
+*       newest chunk if it has room, otherwise from a new chunk at least 
+*       twice as big as the newest one.
+*
+*       In/Out Expectations: expects an arena and a number of bytes, which 
+*       may be 0. Returns memory aligned for any type, which is not zeroed.
+*/
+void *Arena40_alloc(T arena, size_t nbytes) {
+        assert(arena != NULL);
+
+        size_t align = sizeof(union align);
+        nbytes = (nbytes + align - 1) / align * align;
+
+        struct chunk *chunk = arena->chunks;
+        if (chunk == NULL || chunk->u.head.length - chunk->u.head.used < 
+                             nbytes) {
+                size_t length = MIN_CHUNK_LENGTH;
+                if (chunk != NULL && chunk->u.head.length * 2 > length) {
+                        length = chunk->u.head.length * 2;
+                }
+                if (nbytes > length) {
+                        length = nbytes;
+                }
+                chunk = new_chunk(length, chunk);
+                arena->chunks = chunk;
+        }
+
+        void *ptr = (char *)(chunk + 1) + chunk->u.head.used;
+        chunk->u.head.used += nbytes;
+        return ptr;
+}
+
+/*
+*       Description: A function that mallocs a chunk with room for length 
+*       bytes after its header.
+*
+*       In/Out Expectations: expects a length and the chunk to put after the
+*       new one in a list. Returns the new chunk.
+*/
+struct chunk *new_chunk(size_t length, struct chunk *next) {
+        assert(length <= (size_t)-1 - sizeof(struct chunk));
+
+        struct chunk *chunk = malloc(sizeof(*chunk) + length);
+        assert(chunk != NULL);
+
+        chunk->u.head.next = next;
+        chunk->u.head.length = length;
+        chunk->u.head.used = 0;
+        return chunk;
+}
+
+/*
+*       Description: Frees a list of chunks.
+*
+*       In/Out Expectations: expects the first chunk of a list, or NULL. 
+*       Returns void.
+*/
+void free_chunks(struct chunk *chunk) {
+        while (chunk != NULL) {
+                struct chunk *next = chunk->u.head.next;
+                free(chunk);
+                chunk = next;
+        }
+}
@@ -0,0 +1,41 @@
+/******************************************************************************
+*       arena40.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the interface of an arena: memory that is handed
+*       out in pieces and given back all at once. Unlike the CII Arena_T, an
+*       arena shares nothing with other arenas, so each thread can use its
+*       own.
+*   
+******************************************************************************/
+
+#ifndef ARENA40_INCLUDED
+#define ARENA40_INCLUDED
+
+#include <stddef.h>
+
+#define T Arena40_T
+typedef struct T *T;
+
+/* new empty arena */
+extern T     Arena40_new    (void);
+
+/* frees the arena and all memory allocated in it */
+extern void  Arena40_dispose(T *arena);
+
+/* 
+ * allocates nbytes, aligned for any type, which stay valid until the 
+ * arena is disposed
+ */
+extern void *Arena40_alloc  (T arena, size_t nbytes);
+
+/* 
+ * it is a checked run-time error to pass a NULL T
+ * to any function in this interface 
+ */
+
+#undef T
+#endif
@@ -0,0 +1,400 @@
+/******************************************************************************
+*       async40.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*   
+*       Comp40 Project 4: arith
+*   
+*       This file contains the asynchronous file wrappers. A wrapper is made
+*       with fopencookie, so every function that reads or writes a FILE can
+*       use one unchanged. An input wrapper's thread freads the wrapped file
+*       into the free chunks of its ring while the chunks already full are
+*       read through the wrapper; an output wrapper's thread fwrites the full
+*       chunks of its ring to the wrapped file while the next chunk is being
+*       filled through the wrapper. When the ring is full (or empty) one
+*       side waits for the other, so neither can get more than ASYNC_CHUNKS
+*       chunks ahead.
+*   
+******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "assert.h"
+#include "async40.h"
+
+/*
+ * struct chunk
+ *      A struct that holds one chunk of a ring: its bytes and how many of
+ *      them are in use.
+ */
+struct chunk {
+        size_t length;
+        unsigned char bytes[ASYNC_CHUNK_BYTES];
+};
+
+/*
+ * struct async_file
+ *      A struct that holds what a wrapper and its thread share: the wrapped
+ *      file and a ring of chunks, of which count, starting at head, are
+ *      full. The side that fills chunks fills the one at tail, and the side
+ *      that empties them is position bytes into the one at head (for input)
+ *      or fills position bytes of the one at tail (for output). ended says
+ *      no chunk will be filled after the full ones, closed that the input
+ *      wrapper has been closed, and failed that the wrapped file had an
+ *      error. The lock guards head, count, ended, closed and failed.
+ */
+struct async_file {
+        FILE *file;
+        struct chunk chunks[ASYNC_CHUNKS];
+        unsigned head, tail, count;
+        size_t position;
+        bool ended, closed, failed;
+        pthread_mutex_t lock;
+        pthread_cond_t changed;
+        pthread_t thread;
+};
+
+/******** INPUT HELPER FUNCTIONS ********/
+void *read_chunks(void *async);
+ssize_t async_read(void *async, char *bytes, size_t length);
+int close_async_input(void *async);
+
+/******** OUTPUT HELPER FUNCTIONS ********/
+void *write_chunks(void *async);
+ssize_t async_write(void *async, const char *bytes, size_t length);
+void pass_chunk(struct async_file *async);
+int close_async_output(void *async);
+
+/******** HELPER FUNCTIONS ********/
+struct async_file *new_async_file(FILE *file, void *(*run)(void *));
+void free_async_file(struct async_file *async);
+
+
+/************ INPUT ************/
+
+/*
+*       Description: A function that wraps an input file, so its chars are
+*       read ahead by a thread of their own while the ones already read are
+*       used.
+*
+*       In/Out Expectations: Expects an input file open for reading, which
+*       must not be used while the wrapper is open. The wrapper must be
+*       closed with fclose, which leaves the input file open; by then the
+*       input file may have been read up to ASYNC_CHUNKS chunks further than
+*       the wrapper was. Returns the wrapper.
+*/
+FILE *open_async_input(FILE *input) {
+        assert(input != NULL);
+
+        cookie_io_functions_t functions = {
+                async_read, NULL, NULL, close_async_input
+        };
+        struct async_file *async = new_async_file(input, read_chunks);
+        FILE *wrapper = fopencookie(async, "r", functions);
+        assert(wrapper != NULL);
+        return wrapper;
+}
+
+/*
+*       Description: The function the thread of an input wrapper runs.
+*       Fills each free chunk of the ring from the wrapped file, until the
+*       file ends or the wrapper is closed.
+*
+*       In/Out Expectations: Expects the struct async_file of an input
+*       wrapper. Returns NULL.
+*/
+void *read_chunks(void *async) {
+        struct async_file *input = async;
+
+        for (;;) {
+                pthread_mutex_lock(&input->lock);
+                while (input->count == ASYNC_CHUNKS && !input->closed) {
+                        pthread_cond_wait(&input->changed, &input->lock);
+                }
+                bool closed = input->closed;
+                pthread_mutex_unlock(&input->lock);
+                if (closed) {
+                        return NULL;
+                }
+
+                struct chunk *chunk = &input->chunks[input->tail];
+                chunk->length = fread(chunk->bytes, 1, ASYNC_CHUNK_BYTES,
+                                      input->file);
+                bool ended = chunk->length < ASYNC_CHUNK_BYTES;
+
+                pthread_mutex_lock(&input->lock);
+                if (chunk->length > 0) {
+                        input->tail = (input->tail + 1) % ASYNC_CHUNKS;
+                        input->count++;
+                }
+                input->ended = ended;
+                input->failed = ended && ferror(input->file);
+                pthread_cond_broadcast(&input->changed);
+                pthread_mutex_unlock(&input->lock);
+                if (ended) {
+                        return NULL;
+                }
+        }
+}
+
+/*
+*       Description: The read function of an input wrapper. Copies chars
+*       from the chunk at the head of the ring, waiting for the thread to
+*       fill it if it is not full yet, and gives the chunk back to the
+*       thread once all of its chars are copied.
+*
+*       In/Out Expectations: Expects the struct async_file of an input
+*       wrapper, and room for length chars. Returns the number of chars
+*       copied, 0 at the end of the wrapped file, or -1 if it had an error.
+*/
+ssize_t async_read(void *async, char *bytes, size_t length) {
+        struct async_file *input = async;
+
+        pthread_mutex_lock(&input->lock);
+        while (input->count == 0 && !input->ended) {
+                pthread_cond_wait(&input->changed, &input->lock);
+        }
+        if (input->count == 0) {
+                bool failed = input->failed;
+                pthread_mutex_unlock(&input->lock);
+                return failed ? -1 : 0;
+        }
+        pthread_mutex_unlock(&input->lock);
+
+        struct chunk *chunk = &input->chunks[input->head];
+        size_t copied = chunk->length - input->position;
+        if (copied > length) {
+                copied = length;
+        }
+        memcpy(bytes, chunk->bytes + input->position, copied);
+        input->position += copied;
+
+        if (input->position == chunk->length) {
+                input->position = 0;
+                pthread_mutex_lock(&input->lock);
+                input->head = (input->head + 1) % ASYNC_CHUNKS;
+                input->count--;
+                pthread_cond_broadcast(&input->changed);
+                pthread_mutex_unlock(&input->lock);
+        }
+        return copied;
+}
+
+/*
+*       Description: The close function of an input wrapper. Stops its
+*       thread, which finishes the fread it is in first, and frees the
+*       wrapper.
+*
+*       In/Out Expectations: Expects the struct async_file of an input
+*       wrapper. Returns 0.
+*/
+int close_async_input(void *async) {
+        struct async_file *input = async;
+
+        pthread_mutex_lock(&input->lock);
+        input->closed = true;
+        pthread_cond_broadcast(&input->changed);
+        pthread_mutex_unlock(&input->lock);
+
+        pthread_join(input->thread, NULL);
+        free_async_file(input);
+        return 0;
+}
+
+/************ OUTPUT ************/
+
+/*
+*       Description: A function that wraps an output file, so its chars are
+*       written by a thread of their own while the next ones are made.
+*
+*       In/Out Expectations: Expects an output file open for writing, which
+*       must not be used while the wrapper is open. The wrapper must be
+*       closed with fclose, which writes every char left and flushes the
+*       output file, but leaves it open. Chars reach the output file a chunk
+*       at a time, so flushing the wrapper does not flush them. Returns the
+*       wrapper.
+*/
+FILE *open_async_output(FILE *output) {
+        assert(output != NULL);
+
+        cookie_io_functions_t functions = {
+                NULL, async_write, NULL, close_async_output
+        };
+        struct async_file *async = new_async_file(output, write_chunks);
+        FILE *wrapper = fopencookie(async, "w", functions);
+        assert(wrapper != NULL);
+        return wrapper;
+}
+
+/*
+*       Description: The function the thread of an output wrapper runs.
+*       Writes each full chunk of the ring to the wrapped file, until the
+*       wrapper is closed and no full chunk is left, then flushes the file.
+*       Once writing fails, the chunks left are dropped.
+*
+*       In/Out Expectations: Expects the struct async_file of an output
+*       wrapper. Returns NULL.
+*/
+void *write_chunks(void *async) {
+        struct async_file *output = async;
+        bool failed = false;
+
+        for (;;) {
+                pthread_mutex_lock(&output->lock);
+                while (output->count == 0 && !output->ended) {
+                        pthread_cond_wait(&output->changed, &output->lock);
+                }
+                if (output->count == 0) {
+                        pthread_mutex_unlock(&output->lock);
+                        break;
+                }
+                pthread_mutex_unlock(&output->lock);
+
+                struct chunk *chunk = &output->chunks[output->head];
+                if (!failed) {
+                        size_t written = fwrite(chunk->bytes, 1,
+                                                chunk->length, output->file);
+                        failed = written < chunk->length;
+                }
+
+                pthread_mutex_lock(&output->lock);
+                output->head = (output->head + 1) % ASYNC_CHUNKS;
+                output->count--;
+                pthread_cond_broadcast(&output->changed);
+                pthread_mutex_unlock(&output->lock);
+        }
+
+        if (fflush(output->file) != 0) {
+                failed = true;
+        }
+        pthread_mutex_lock(&output->lock);
+        output->failed = failed;
+        pthread_mutex_unlock(&output->lock);
+        return NULL;
+}
+
+/*
+*       Description: The write function of an output wrapper. Copies chars
+*       into the chunk at the tail of the ring, passing each chunk it fills
+*       to the thread.
+*
+*       In/Out Expectations: Expects the struct async_file of an output
+*       wrapper, and length chars. Returns length, since every char is
+*       taken; an error writing them is reported when the wrapper is closed.
+*/
+ssize_t async_write(void *async, const char *bytes, size_t length) {
+        struct async_file *output = async;
+        size_t copied = 0;
+
+        while (copied < length) {
+                struct chunk *chunk = &output->chunks[output->tail];
+                size_t n = ASYNC_CHUNK_BYTES - output->position;
+                if (n > length - copied) {
+                        n = length - copied;
+                }
+                memcpy(chunk->bytes + output->position, bytes + copied, n);
+                output->position += n;
+                copied += n;
+                if (output->position == ASYNC_CHUNK_BYTES) {
+                        pass_chunk(output);
+                }
+        }
+        return length;
+}
+
+/*
+*       Description: A function that passes the chunk at the tail of the
+*       ring of an output wrapper to its thread, then waits until the next
+*       chunk is free to fill.
+*
+*       In/Out Expectations: Expects the struct async_file of an output
+*       wrapper. Returns void.
+*/
+void pass_chunk(struct async_file *async) {
+        async->chunks[async->tail].length = async->position;
+        async->position = 0;
+
+        pthread_mutex_lock(&async->lock);
+        async->tail = (async->tail + 1) % ASYNC_CHUNKS;
+        async->count++;
+        pthread_cond_broadcast(&async->changed);
+        while (async->count == ASYNC_CHUNKS) {
+                pthread_cond_wait(&async->changed, &async->lock);
+        }
+        pthread_mutex_unlock(&async->lock);
+}
+
+/*
+*       Description: The close function of an output wrapper. Passes the
+*       last chunk to its thread, waits for the thread to write every chunk
+*       and frees the wrapper.
+*
+*       In/Out Expectations: Expects the struct async_file of an output
+*       wrapper. Returns 0, or -1 if writing to the wrapped file failed, 
+*       which fwrite or fflush has then marked in its error indicator.
+*/
+int close_async_output(void *async) {
+        struct async_file *output = async;
+
+        if (output->position > 0) {
+                pass_chunk(output);
+        }
+        pthread_mutex_lock(&output->lock);
+        output->ended = true;
+        pthread_cond_broadcast(&output->changed);
+        pthread_mutex_unlock(&output->lock);
+
+        pthread_join(output->thread, NULL);
+        bool failed = output->failed;
+        free_async_file(output);
+        return failed ? -1 : 0;
+}
+
+/************ HELPERS ************/
+
+/*
+*       Description: A function that creates the shared state of a wrapper,
+*       with an empty ring, and starts its thread.
+*
+*       In/Out Expectations: Expects the file to wrap and the function the
+*       thread runs. Mallocs the state, which must be freed with
+*       free_async_file once the thread is joined. Returns the state.
+*/
+struct async_file *new_async_file(FILE *file, void *(*run)(void *)) {
+        struct async_file *async = malloc(sizeof(*async));
+        assert(async != NULL);
+
+        async->file = file;
+        async->head = 0;
+        async->tail = 0;
+        async->count = 0;
+        async->position = 0;
+        async->ended = false;
+        async->closed = false;
+        async->failed = false;
+        pthread_mutex_init(&async->lock, NULL);
+        pthread_cond_init(&async->changed, NULL);
+
+        int error = pthread_create(&async->thread, NULL, run, async);
+        assert(error == 0);
+        return async;
+}
+
+/*
+*       Description: Frees memory associated with the shared state of a
+*       wrapper.
+*
+*       In/Out Expectations: Expects state made by new_async_file, whose
+*       thread has been joined. Returns void.
+*/
+void free_async_file(struct async_file *async) {
+        pthread_mutex_destroy(&async->lock);
+        pthread_cond_destroy(&async->changed);
+        free(async);
+}
@@ -0,0 +1,30 @@
+/******************************************************************************
+*       async40.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*   
+*       Comp40 Project 4: arith
+*   
+*       This file contains the declarations of the asynchronous file
+*       wrappers. Each one is a FILE that stands in front of another file,
+*       with a thread of its own reading ahead of, or writing behind, the
+*       thread that uses it, through a ring of ASYNC_CHUNKS chunks. Reading
+*       the next chunk, converting the current one and writing the last one
+*       happen at once, so the time spent waiting on pipes and slow disks
+*       hides behind the time spent converting.
+*   
+******************************************************************************/
+
+#ifndef ASYNC40_
+#define ASYNC40_
+
+#include <stdio.h>
+
+/* the number of chunks in the ring of a wrapper, and the bytes in each */
+#define ASYNC_CHUNKS 4
+#define ASYNC_CHUNK_BYTES (64 * 1024)
+
+FILE *open_async_input(FILE *input);
+FILE *open_async_output(FILE *output);
+
+#endif
@@ -0,0 +1,230 @@
+/******************************************************************************
+*       batch40.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the functions necessary to compress or decompress
+*       a list of images in one process. Every line of the list names an 
+*       input file and the output file to write, separated by whitespace.
+*       A pool of threads takes the images one at a time, and each thread 
+*       reuses its buffers from one image to the next.
+*   
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "assert.h"
+#include "compress40.h"
+#include "batch40.h"
+
+#define LIST_SEPARATORS " \t\r\n"
+
+/* 
+ * struct job
+ *      A struct that holds one line of the list: the file to read and the
+ *      file to write.
+ */
+struct job {
+        char *input;
+        char *output;
+};
+
+/* 
+ * struct batch
+ *      A struct that holds the work shared by every thread of a batch: the
+ *      jobs, the index of the next job nobody has taken, the number of jobs
+ *      that failed, and the lock that guards both.
+ */
+struct batch {
+        struct job *jobs;
+        unsigned count;
+        unsigned next;
+        unsigned failures;
+        bool compress;
+        arith40_options options;
+        pthread_mutex_t lock;
+};
+
+/******** BATCH HELPER FUNCTIONS ********/
+unsigned read_jobs(FILE *list, struct job **jobs);
+void *run_jobs(void *batch);
+bool run_job(struct job *job, bool compress, arith40_options options);
+
+/*
+*       Description: A function that compresses or decompresses every image
+*       named by a list file, on as many threads as the options ask for.
+*       Each image is done on one thread with the other options, so it is 
+*       written with exactly the same bytes as it would be by itself.
+*
+*       In/Out Expectations: expects a list file open for reading, whether 
+*       to compress or decompress, and options or NULL. A file that cannot 
+*       be opened is reported on stderr and skipped. Returns the number of
+*       images that were not written.
+*/
+int batch40(FILE *list, bool compress, arith40_options options)
+{
+        assert(list != NULL);
+
+        struct arith40_options defaults = ARITH40_DEFAULT_OPTIONS;
+        if (options == NULL) {
+                options = &defaults;
+        }
+
+        struct batch batch;
+        batch.count = read_jobs(list, &batch.jobs);
+        batch.next = 0;
+        batch.failures = 0;
+        batch.compress = compress;
+        batch.options = options;
+        pthread_mutex_init(&batch.lock, NULL);
+
+        unsigned threads = options->threads;
+        if (threads > batch.count) {
+                threads = batch.count;
+        }
+        if (threads < 1) {
+                threads = 1;
+        }
+
+        pthread_t workers[threads];
+        for (unsigned t = 0; t < threads; t++) {
+                int error = pthread_create(&workers[t], NULL, run_jobs, 
+                                           &batch);
+                assert(error == 0);
+        }
+        for (unsigned t = 0; t < threads; t++) {
+                pthread_join(workers[t], NULL);
+        }
+
+        for (unsigned i = 0; i < batch.count; i++) {
+                free(batch.jobs[i].input);
+                free(batch.jobs[i].output);
+        }
+        free(batch.jobs);
+        pthread_mutex_destroy(&batch.lock);
+
+        return batch.failures;
+}
+
+/*
+*       Description: A function that reads every line of a list file into an
+*       array of jobs. Blank lines and lines starting with '#' are skipped.
+*
+*       In/Out Expectations: expects a list file open for reading, where each
+*       other line holds two paths without whitespace in them, and a pointer
+*       to set to the array. Asserts that no line holds just one path. The
+*       array and its paths must be freed by the client. Returns the number 
+*       of jobs.
+*/
+unsigned read_jobs(FILE *list, struct job **jobs)
+{
+        unsigned count = 0, length = 0;
+        char *line = NULL;
+        size_t line_length = 0;
+        *jobs = NULL;
+
+        while (getline(&line, &line_length, list) != -1) {
+                char *save;
+                char *input = strtok_r(line, LIST_SEPARATORS, &save);
+                if (input == NULL || *input == '#') {
+                        continue;
+                }
+                char *output = strtok_r(NULL, LIST_SEPARATORS, &save);
+                assert(output != NULL);
+
+                if (count == length) {
+                        length = length * 2 + 1;
+                        *jobs = realloc(*jobs, length * sizeof(**jobs));
+                        assert(*jobs != NULL);
+                }
+                (*jobs)[count].input = strdup(input);
+                (*jobs)[count].output = strdup(output);
+                assert((*jobs)[count].input != NULL);
+                assert((*jobs)[count].output != NULL);
+                count++;
+        }
+
+        free(line);
+        return count;
+}
+
+/*
+*       Description: The function each thread of a batch runs. Takes the next
+*       job until there are none left, running each one with its own copy of
+*       the options: one thread per image and buffers kept for the next one.
+*
+*       In/Out Expectations: expects a pointer to the struct batch shared by
+*       all threads. Frees its buffers once there are no jobs left. Returns 
+*       NULL.
+*/
+void *run_jobs(void *batch)
+{
+        struct batch *curr_batch = batch;
+        struct arith40_options options = *curr_batch->options;
+        options.threads = 1;
+        options.buffers = new_arith40_buffers();
+
+        for (;;) {
+                pthread_mutex_lock(&curr_batch->lock);
+                unsigned i = curr_batch->next;
+                if (i < curr_batch->count) {
+                        curr_batch->next++;
+                }
+                pthread_mutex_unlock(&curr_batch->lock);
+                if (i >= curr_batch->count) {
+                        break;
+                }
+
+                if (!run_job(&curr_batch->jobs[i], curr_batch->compress, 
+                             &options)) {
+                        pthread_mutex_lock(&curr_batch->lock);
+                        curr_batch->failures++;
+                        pthread_mutex_unlock(&curr_batch->lock);
+                }
+        }
+
+        free_arith40_buffers(&options.buffers);
+        return NULL;
+}
+
+/*
+*       Description: A function that opens the files of a job and compresses
+*       or decompresses the input file into the output file.
+*
+*       In/Out Expectations: expects a job, whether to compress or 
+*       decompress, and the options to use. Reports a file that cannot be 
+*       opened or written on stderr. Returns true if the output file was 
+*       written.
+*/
+bool run_job(struct job *job, bool compress, arith40_options options)
+{
+        FILE *input = fopen(job->input, "rb");
+        if (input == NULL) {
+                fprintf(stderr, "%s: cannot open for reading\n", job->input);
+                return false;
+        }
+        FILE *output = fopen(job->output, "wb");
+        if (output == NULL) {
+                fprintf(stderr, "%s: cannot open for writing\n", job->output);
+                fclose(input);
+                return false;
+        }
+
+        if (compress) {
+                compress40_with(input, output, options);
+        } else {
+                decompress40_with(input, output, options);
+        }
+
+        fclose(input);
+        if (ferror(output) | fclose(output)) {
+                fprintf(stderr, "%s: cannot write\n", job->output);
+                return false;
+        }
+        return true;
+}
@@ -0,0 +1,22 @@
+/******************************************************************************
+*       batch40.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the declaration of batch40, which compresses or
+*       decompresses many images in one process.
+*   
+******************************************************************************/
+
+#ifndef BATCH40_
+#define BATCH40_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "compress40.h"
+
+int batch40(FILE *list, bool compress, arith40_options options);
+
+#endif
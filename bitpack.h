@@ -1,17 +1,51 @@
-#ifndef BITPACK_INCLUDED
-#define BITPACK_INCLUDED
-#include <stdbool.h>
-#include <stdint.h>
-#include "except.h"
-
-bool Bitpack_fitsu(uint64_t n, unsigned width);
-bool Bitpack_fitss( int64_t n, unsigned width);
-uint64_t Bitpack_getu(uint64_t word, unsigned width, unsigned lsb);
-int64_t Bitpack_gets(uint64_t word, unsigned width, unsigned lsb);
-uint64_t Bitpack_newu(uint64_t word, unsigned width, unsigned lsb, 
-                      uint64_t value);
-uint64_t Bitpack_news(uint64_t word, unsigned width, unsigned lsb, 
-                      int64_t value);
-extern Except_T Bitpack_Overflow;
-
-#endif
+#ifndef BITPACK_INCLUDED
+#define BITPACK_INCLUDED
+#include <stdbool.h>
+#include <stdint.h>
+#include "except.h"
+
+bool Bitpack_fitsu(uint64_t n, unsigned width);
+bool Bitpack_fitss( int64_t n, unsigned width);
+uint64_t Bitpack_getu(uint64_t word, unsigned width, unsigned lsb);
+int64_t Bitpack_gets(uint64_t word, unsigned width, unsigned lsb);
+uint64_t Bitpack_newu(uint64_t word, unsigned width, unsigned lsb, 
+                      uint64_t value);
+uint64_t Bitpack_news(uint64_t word, unsigned width, unsigned lsb, 
+                      int64_t value);
+extern Except_T Bitpack_Overflow;
+
+/*
+ * Unchecked versions of Bitpack_getu, Bitpack_gets, Bitpack_newu and 
+ * Bitpack_news for fields whose width and lsb are constants, such as the 
+ * fields of a compressed word: with the width and lsb known when compiling,
+ * each one is a shift and a mask. Nothing is checked, so the width must be
+ * from 1 to 63, the field must fit in 64 bits, and a new value must fit in
+ * the width (the bits that do not are dropped, not raised as an overflow).
+ * Callers that cannot promise this use the checked functions above.
+ */
+static inline uint64_t Bitpack_getu_fixed(uint64_t word, unsigned width, 
+                                          unsigned lsb)
+{
+        return (word >> lsb) & ((UINT64_C(1) << width) - 1);
+}
+
+static inline int64_t Bitpack_gets_fixed(uint64_t word, unsigned width, 
+                                         unsigned lsb)
+{
+        return (int64_t)(word << (64 - width - lsb)) >> (64 - width);
+}
+
+static inline uint64_t Bitpack_newu_fixed(uint64_t word, unsigned width, 
+                                          unsigned lsb, uint64_t value)
+{
+        uint64_t mask = ((UINT64_C(1) << width) - 1) << lsb;
+        return (word & ~mask) | ((value << lsb) & mask);
+}
+
+static inline uint64_t Bitpack_news_fixed(uint64_t word, unsigned width, 
+                                          unsigned lsb, int64_t value)
+{
+        return Bitpack_newu_fixed(word, width, lsb, (uint64_t)value);
+}
+
+#endif
@@ -0,0 +1,122 @@
+/******************************************************************************
+*       bitstream.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains the functions of the bit_writer and bit_reader
+*       that are not called once per field: opening and closing them,
+*       telling if a reader has read past the end of its stream, and reading
+*       the last few chars of a stream. The functions that put and get the
+*       fields themselves are inline, in bitstream.h.
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "assert.h"
+#include "bitstream.h"
+
+/************ WRITING ************/
+
+/*
+*       Description: A function that opens a bit_writer over chars held in
+*       memory.
+*
+*       In/Out Expectations: Expects a bit_writer, which may be on the
+*       stack, and chars with room for every field that will be put, padded
+*       to a whole char. Returns void.
+*/
+void open_bit_writer(bit_writer writer, unsigned char *bytes) {
+        assert(writer != NULL && bytes != NULL);
+        writer->bytes = bytes;
+        writer->used = 0;
+        writer->bits = 0;
+        writer->count = 0;
+}
+
+/*
+*       Description: A function that stores the bits of a bit_writer not
+*       yet in its chars, the last of them padded with 0 bits to a whole
+*       char.
+*
+*       In/Out Expectations: Expects an open bit_writer, which no field is
+*       put to after. Returns the number of chars of the stream.
+*/
+size_t close_bit_writer(bit_writer writer) {
+        assert(writer != NULL);
+        unsigned padding = (STREAM_CHAR_BITS - writer->count %
+                            STREAM_CHAR_BITS) % STREAM_CHAR_BITS;
+        uint64_t bits = writer->bits << padding;
+        unsigned count = writer->count + padding;
+        while (count > 0) {
+                count -= STREAM_CHAR_BITS;
+                writer->bytes[writer->used++] = bits >> count;
+        }
+        writer->bits = 0;
+        writer->count = 0;
+        return writer->used;
+}
+
+/************ READING ************/
+
+/*
+*       Description: A function that opens a bit_reader over a stream held
+*       in memory, at any bit of it.
+*
+*       In/Out Expectations: Expects a bit_reader, which may be on the
+*       stack, the length chars of the stream, and the bit the first field
+*       read starts at, counted from the most significant bit of the first
+*       char. Returns void.
+*/
+void open_bit_reader(bit_reader reader, const unsigned char *bytes,
+                     size_t length, uint64_t bit) {
+        assert(reader != NULL);
+        assert(bytes != NULL || length == 0);
+        reader->bytes = bytes;
+        reader->length = length;
+        reader->position = bit / STREAM_CHAR_BITS;
+        reader->bits = 0;
+        reader->count = 0;
+        if (bit % STREAM_CHAR_BITS != 0) {
+                refill_bit_reader(reader);
+                bit_reader_skip(reader, bit % STREAM_CHAR_BITS);
+        }
+}
+
+/*
+*       Description: A function that tells if every bit a bit_reader has
+*       given so far was in its stream.
+*
+*       In/Out Expectations: Expects an open bit_reader. Returns true if no
+*       bits past the end of the stream have been got or skipped.
+*/
+bool bit_reader_valid(bit_reader reader) {
+        assert(reader != NULL);
+        return (uint64_t)reader->position * STREAM_CHAR_BITS - reader->count
+               <= (uint64_t)reader->length * STREAM_CHAR_BITS;
+}
+
+/*
+*       Description: A function that gives the 8 chars of a stream starting
+*       at a position as 64 bits, the first char the most significant, when
+*       some of them are past the end of the stream, which are read as 0
+*       bits.
+*
+*       In/Out Expectations: Expects an array of length bytes and any
+*       position. Returns the bits.
+*/
+uint64_t load_bits_tail(const unsigned char *bytes, size_t length,
+                        size_t position) {
+        uint64_t bits = 0;
+        for (unsigned k = 0; k < STREAM_BUFFER_BITS / STREAM_CHAR_BITS; k++) {
+                bits <<= STREAM_CHAR_BITS;
+                if (position + k < length) {
+                        bits |= bytes[position + k];
+                }
+        }
+        return bits;
+}
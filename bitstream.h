@@ -0,0 +1,206 @@
+/******************************************************************************
+*       bitstream.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains a bit_writer and a bit_reader, which put and get
+*       fields of any width from 1 to 64 bits, signed or unsigned, to and
+*       from chars held in memory, most significant bit first, crossing
+*       from one char (or word) into the next wherever a field does. A
+*       field is what Bitpack_getu, Bitpack_gets, Bitpack_newu and
+*       Bitpack_news would get and set in a word, but in a stream instead
+*       of in 64 bits. Bits are written 32 at a time and read 64 at a time,
+*       and the functions that put and get a field are inline, so with a
+*       constant width each one is a few shifts and masks. Like the fixed
+*       Bitpack functions, nothing is checked: a value put must fit in its
+*       width.
+*
+******************************************************************************/
+
+#ifndef BITSTREAM_
+#define BITSTREAM_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* the bits a bit_reader holds at once, and the bits of a char */
+#define STREAM_BUFFER_BITS 64
+#define STREAM_CHAR_BITS 8
+
+/* the bits a bit_writer stores at once */
+#define STREAM_STORE_BITS 32
+
+/*
+ * The most bits a bit_reader holds just after it is refilled is at least
+ * this many, so this many bits can be peeked or skipped after one refill
+ */
+#define STREAM_REFILL_BITS (STREAM_BUFFER_BITS - STREAM_CHAR_BITS)
+
+/*
+ * struct bit_writer
+ *      A struct that collects fields, most significant bit first, into the
+ *      chars of a stream held in memory, used of them so far. count is the
+ *      number of bits at the bottom of bits not yet stored in a char, fewer
+ *      than STREAM_STORE_BITS between calls.
+ */
+typedef struct bit_writer {
+        unsigned char *bytes;
+        size_t used;
+        uint64_t bits;
+        unsigned count;
+} *bit_writer;
+
+/*
+ * struct bit_reader
+ *      A struct that reads the fields of a stream of length chars held in
+ *      memory: the position of the next char not yet in bits, and the bits
+ *      read ahead of the next field, count of them, the first of them the
+ *      most significant bit of bits. Bits past the end of the stream are
+ *      read as 0 bits.
+ */
+typedef struct bit_reader {
+        const unsigned char *bytes;
+        size_t length, position;
+        uint64_t bits;
+        unsigned count;
+} *bit_reader;
+
+/********** WRITING **********/
+void open_bit_writer(bit_writer writer, unsigned char *bytes);
+size_t close_bit_writer(bit_writer writer);
+static inline void bit_writer_putu(bit_writer writer, unsigned width,
+                                   uint64_t value);
+static inline void bit_writer_puts(bit_writer writer, unsigned width,
+                                   int64_t value);
+
+/********** READING **********/
+void open_bit_reader(bit_reader reader, const unsigned char *bytes,
+                     size_t length, uint64_t bit);
+bool bit_reader_valid(bit_reader reader);
+uint64_t load_bits_tail(const unsigned char *bytes, size_t length,
+                        size_t position);
+static inline void refill_bit_reader(bit_reader reader);
+static inline uint64_t bit_reader_peek(bit_reader reader, unsigned width);
+static inline void bit_reader_skip(bit_reader reader, unsigned width);
+static inline uint64_t bit_reader_getu(bit_reader reader, unsigned width);
+static inline int64_t bit_reader_gets(bit_reader reader, unsigned width);
+
+
+/*
+ * Puts the width low bits of value in the stream, width from 1 to 64; a
+ * field wider than STREAM_STORE_BITS is put as two. Whenever a
+ * STREAM_STORE_BITS bits are collected they are stored in 4 chars at once,
+ * the writer's chars having room for every field put.
+ */
+static inline void bit_writer_putu(bit_writer writer, unsigned width,
+                                   uint64_t value)
+{
+        if (width > STREAM_STORE_BITS) {
+                bit_writer_putu(writer, width - STREAM_STORE_BITS,
+                                value >> STREAM_STORE_BITS);
+                width = STREAM_STORE_BITS;
+                value &= UINT32_MAX;
+        }
+        writer->bits = writer->bits << width | value;
+        writer->count += width;
+        if (writer->count >= STREAM_STORE_BITS) {
+                writer->count -= STREAM_STORE_BITS;
+                uint32_t stored = writer->bits >> writer->count;
+                unsigned char *bytes = writer->bytes + writer->used;
+                bytes[0] = stored >> 24;
+                bytes[1] = stored >> 16;
+                bytes[2] = stored >> 8;
+                bytes[3] = stored;
+                writer->used += STREAM_STORE_BITS / STREAM_CHAR_BITS;
+        }
+}
+
+/* Puts a signed value that fits in width bits, width from 1 to 64 */
+static inline void bit_writer_puts(bit_writer writer, unsigned width,
+                                   int64_t value)
+{
+        uint64_t mask = width < STREAM_BUFFER_BITS ?
+                        (UINT64_C(1) << width) - 1 : UINT64_MAX;
+        bit_writer_putu(writer, width, (uint64_t)value & mask);
+}
+
+/*
+ * Tops up the bits of a reader with the 8 chars after the ones already in
+ * it, without a loop or a branch away from the end of the stream: the whole
+ * chars that fit are counted as read, and the bits of a char that only
+ * partly fits are read again next time. Leaves the reader holding at least
+ * STREAM_REFILL_BITS bits.
+ */
+static inline void refill_bit_reader(bit_reader reader)
+{
+        const unsigned char *bytes = reader->bytes + reader->position;
+        uint64_t loaded;
+        if (reader->position < reader->length &&
+            reader->length - reader->position >=
+            STREAM_BUFFER_BITS / STREAM_CHAR_BITS) {
+                loaded = (uint64_t)bytes[0] << 56 |
+                         (uint64_t)bytes[1] << 48 |
+                         (uint64_t)bytes[2] << 40 |
+                         (uint64_t)bytes[3] << 32 |
+                         (uint64_t)bytes[4] << 24 |
+                         (uint64_t)bytes[5] << 16 |
+                         (uint64_t)bytes[6] << 8 | (uint64_t)bytes[7];
+        } else {
+                loaded = load_bits_tail(reader->bytes, reader->length,
+                                        reader->position);
+        }
+        reader->bits |= loaded >> reader->count;
+        reader->position += (STREAM_BUFFER_BITS - 1 - reader->count) /
+                            STREAM_CHAR_BITS;
+        reader->count |= STREAM_REFILL_BITS;
+}
+
+/*
+ * Gives the next width bits of a reader holding at least width bits,
+ * width from 1 to 64, without taking them
+ */
+static inline uint64_t bit_reader_peek(bit_reader reader, unsigned width)
+{
+        return reader->bits >> (STREAM_BUFFER_BITS - width);
+}
+
+/* Takes width bits from a reader holding at least that many, from 0 to 63 */
+static inline void bit_reader_skip(bit_reader reader, unsigned width)
+{
+        reader->bits <<= width;
+        reader->count -= width;
+}
+
+/*
+ * Gets the next field of width bits as an unsigned value, width from 1 to
+ * 64, refilling the reader first if it holds fewer; a field wider than
+ * STREAM_REFILL_BITS is got as two.
+ */
+static inline uint64_t bit_reader_getu(bit_reader reader, unsigned width)
+{
+        if (width > STREAM_REFILL_BITS) {
+                uint64_t high = bit_reader_getu(reader,
+                                                width - STREAM_STORE_BITS);
+                return high << STREAM_STORE_BITS |
+                       bit_reader_getu(reader, STREAM_STORE_BITS);
+        }
+        if (reader->count < width) {
+                refill_bit_reader(reader);
+        }
+        uint64_t value = bit_reader_peek(reader, width);
+        bit_reader_skip(reader, width);
+        return value;
+}
+
+/* Gets the next field of width bits as a signed value, width from 1 to 64 */
+static inline int64_t bit_reader_gets(bit_reader reader, unsigned width)
+{
+        uint64_t value = bit_reader_getu(reader, width);
+        unsigned shift = STREAM_BUFFER_BITS - width;
+        return (int64_t)(value << shift) >> shift;
+}
+
+#endif
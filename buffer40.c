@@ -0,0 +1,331 @@
+/******************************************************************************
+*       buffer40.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the functions necessary to compress an image held
+*       in memory into a buffer, and decompress a buffer into an image held 
+*       in memory. They use the fused codec in word_rgb.c one block at a time
+*       and the byte conversions in file_word.c, so they write exactly the 
+*       bytes compress40 and decompress40 write, but they never open a file 
+*       or allocate memory and share nothing between calls.
+*   
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "assert.h"
+#include "file_word.h"
+#include "file_tile.h"
+#include "word_rgb.h"
+#include "word_layout.h"
+#include "buffer40.h"
+
+#define BLOCK_SIZE 2
+#define BYTES_PER_WORD 4
+#define CHAR_BITS 8
+#define MAX_DENOMINATOR 65535
+
+/* the words of a column converted at once */
+#define COLUMN_RUN 64
+
+/******** DECOMPRESSION HELPER FUNCTIONS ********/
+bool tiles_to_image(const unsigned char *input, size_t length, 
+                    arith40_image image);
+bool entropy_to_image(const unsigned char *input, size_t length, 
+                      arith40_image image);
+bool progressive_to_image(const unsigned char *input, size_t length, 
+                          arith40_image image);
+bool layout_to_image(const unsigned char *input, size_t length, 
+                     word_layout layout, arith40_image image);
+
+
+/************ COMPRESSION ************/
+
+/*
+*       Description: A function that gives the number of bytes a compressed 
+*       image of the given size takes, header included.
+*
+*       In/Out Expectations: expects the width and height of an image, in 
+*       pixels. Returns the number of bytes.
+*/
+size_t compress40_length(unsigned width, unsigned height) {
+        unsigned char header[MAX_HEADER_LENGTH];
+        unsigned columns = width / BLOCK_SIZE;
+        unsigned rows = height / BLOCK_SIZE;
+
+        size_t header_length = header_to_bytes(FORMAT_COLUMNS, 
+                columns * BLOCK_SIZE, rows * BLOCK_SIZE, header, 
+                MAX_HEADER_LENGTH);
+        return header_length + (size_t)columns * rows * BYTES_PER_WORD;
+}
+
+/*
+*       Description: A function that compresses an image held in memory into
+*       a buffer, in the format compress40 writes. Blocks are converted 
+*       column by column, COLUMN_RUN at a time, so the words are written to
+*       the buffer in order.
+*
+*       In/Out Expectations: expects a valid image whose samples are no more
+*       than its maxval, and an output buffer of length bytes. Returns the 
+*       number of bytes written, which is compress40_length of the image, or
+*       0 if that is more than length, in which case nothing is written.
+*/
+size_t compress40_buffer(arith40_image image, unsigned char *output, 
+                         size_t length) {
+        assert(image != NULL && image->pixels != NULL);
+        assert(output != NULL);
+        assert(image->maxval > 0 && image->maxval <= MAX_DENOMINATOR);
+
+        unsigned columns = image->width / BLOCK_SIZE;
+        unsigned rows = image->height / BLOCK_SIZE;
+        size_t total = compress40_length(image->width, image->height);
+        if (total > length) {
+                return 0;
+        }
+
+        size_t position = header_to_bytes(FORMAT_COLUMNS, 
+                columns * BLOCK_SIZE, rows * BLOCK_SIZE, output, length);
+        uint32_t words[COLUMN_RUN];
+        for (unsigned col = 0; col < columns; col++) {
+                for (unsigned row = 0; row < rows; row += COLUMN_RUN) {
+                        unsigned count = rows - row < COLUMN_RUN ? 
+                                         rows - row : COLUMN_RUN;
+                        image_to_word_run(image, col, row, row + count, 
+                                          words);
+                        for (unsigned k = 0; k < count; k++) {
+                                word_to_bytes(words[k], output + position);
+                                position += BYTES_PER_WORD;
+                        }
+                }
+        }
+        return position;
+}
+
+/************ DECOMPRESSION ************/
+
+/*
+*       Description: A function that reads the size of a compressed image 
+*       held in memory from its header.
+*
+*       In/Out Expectations: expects an input buffer of length bytes and an
+*       unsigned width and height, passed by reference, which are set from
+*       the header. Returns false, leaving them unset, if the input does not
+*       start with a valid header.
+*/
+bool decompress40_size(const unsigned char *input, size_t length, 
+                       unsigned *width, unsigned *height) {
+        assert(input != NULL);
+        assert(width != NULL && height != NULL);
+
+        unsigned format, header_width, header_height;
+        if (bytes_to_header(input, length, &format, &header_width, 
+                            &header_height) == 0) {
+                return false;
+        }
+        *width = header_width;
+        *height = header_height;
+        return true;
+}
+
+/*
+*       Description: A function that decompresses a compressed image held in
+*       memory, in any format, into an image held in memory. The pixels 
+*       are the ones decompress40_with writes with the maxval of the image.
+*
+*       In/Out Expectations: expects an input buffer of length bytes and a 
+*       valid image with the width and height of the header, whose maxval 
+*       and stride are chosen by the client. Returns true once every pixel 
+*       of the image is set, or false, leaving the image untouched, if the
+*       header is not valid, its size is not the size of the image, or the 
+*       input is too short to hold every word.
+*/
+bool decompress40_buffer(const unsigned char *input, size_t length,
+                         arith40_image image) {
+        assert(input != NULL);
+        assert(image != NULL && image->pixels != NULL);
+        assert(image->maxval > 0 && image->maxval <= MAX_DENOMINATOR);
+
+        unsigned format, width, height;
+        size_t position = bytes_to_header(input, length, &format, &width, 
+                                          &height);
+        if (position == 0 || width != image->width || 
+            height != image->height) {
+                return false;
+        }
+        if (format == FORMAT_TILES) {
+                return tiles_to_image(input + position, length - position, 
+                                      image);
+        }
+        if (format == FORMAT_ENTROPY) {
+                return entropy_to_image(input + position, length - position,
+                                        image);
+        }
+        if (format == FORMAT_PROGRESSIVE) {
+                return progressive_to_image(input + position, 
+                                            length - position, image);
+        }
+        if (format == FORMAT_FINE) {
+                return layout_to_image(input + position, length - position,
+                                       format_to_layout(format), image);
+        }
+        unsigned columns = width / BLOCK_SIZE;
+        unsigned rows = height / BLOCK_SIZE;
+        if ((length - position) / BYTES_PER_WORD < (size_t)columns * rows) {
+                return false;
+        }
+
+        for (unsigned col = 0; col < columns; col++) {
+                for (unsigned row = 0; row < rows; row++) {
+                        size_t k = format == FORMAT_ROWS ? 
+                                (size_t)row * columns + col : 
+                                (size_t)col * rows + row;
+                        word_to_image(bytes_to_word(input + position + 
+                                                    k * BYTES_PER_WORD), 
+                                      image, col, row);
+                }
+        }
+        return true;
+}
+
+/*
+*       Description: A function that decompresses the tiles of a tiled image
+*       held in memory (format 4) into an image held in memory, checking 
+*       every tile before any pixel is set.
+*
+*       In/Out Expectations: expects the length bytes that follow a header in
+*       format 4, and a valid image with the width and height of the header.
+*       Returns true once every pixel of the image is set, or false, leaving
+*       the image untouched, if the index or any tile is not valid.
+*/
+bool tiles_to_image(const unsigned char *input, size_t length, 
+                    arith40_image image) {
+        struct tile_index index;
+        struct tile curr_tile;
+        if (bytes_to_tile_index(input, length, image->width, image->height, 
+                                &index) == 0) {
+                return false;
+        }
+
+        size_t count = (size_t)index.tile_columns * index.tile_rows;
+        for (size_t k = 0; k < count; k++) {
+                if (!index_to_tile(&index, k, &curr_tile)) {
+                        return false;
+                }
+        }
+        for (size_t k = 0; k < count; k++) {
+                index_to_tile(&index, k, &curr_tile);
+                word_tile_to_image(index.data + curr_tile.offset, &curr_tile,
+                                   image, NULL);
+        }
+        return true;
+}
+
+/*
+*       Description: A function that decompresses an entropy coded image 
+*       held in memory (format 5) into an image held in memory. The words 
+*       are decoded twice, the first time only to check that every one of 
+*       them is in the input, so no pixel is set unless they all are.
+*
+*       In/Out Expectations: expects the length bytes that follow a header in
+*       format 5, and a valid image with the width and height of the header.
+*       Returns true once every pixel of the image is set, or false, leaving
+*       the image untouched, if the code lengths are not valid or the input
+*       is too short.
+*/
+bool entropy_to_image(const unsigned char *input, size_t length, 
+                      arith40_image image) {
+        struct entropy_reader reader;
+        unsigned columns = image->width / BLOCK_SIZE;
+        unsigned rows = image->height / BLOCK_SIZE;
+        uint32_t word;
+
+        if (open_entropy_reader(&reader, input, length) == 0) {
+                return false;
+        }
+        for (size_t k = 0; k < (size_t)columns * rows; k++) {
+                entropy_words(&reader, &word, 1);
+        }
+        if (!entropy_reader_valid(&reader)) {
+                return false;
+        }
+
+        open_entropy_reader(&reader, input, length);
+        for (unsigned col = 0; col < columns; col++) {
+                for (unsigned row = 0; row < rows; row++) {
+                        entropy_words(&reader, &word, 1);
+                        word_to_image(word, image, col, row);
+                }
+        }
+        return true;
+}
+
+/*
+*       Description: A function that decompresses a progressive image held 
+*       in memory (format 6) into an image held in memory, one column of 
+*       blocks at a time.
+*
+*       In/Out Expectations: expects the length bytes that follow a header in
+*       format 6, and a valid image with the width and height of the header.
+*       Returns true once every pixel of the image is set, or false, leaving
+*       the image untouched, if the input is too short to hold both parts.
+*/
+bool progressive_to_image(const unsigned char *input, size_t length, 
+                          arith40_image image) {
+        unsigned columns = image->width / BLOCK_SIZE;
+        unsigned rows = image->height / BLOCK_SIZE;
+        size_t total = (size_t)columns * rows;
+        if (length < progressive_length(total)) {
+                return false;
+        }
+
+        for (unsigned col = 0; col < columns; col++) {
+                for (unsigned row = 0; row < rows; row++) {
+                        uint32_t word;
+                        progressive_words(input, length, total, 
+                                          (size_t)col * rows + row, &word, 
+                                          1);
+                        word_to_image(word, image, col, row);
+                }
+        }
+        return true;
+}
+
+/*
+*       Description: A function that decompresses the words of a layout 
+*       wider than the standard one held in memory, in the order of format 
+*       2, each stored as its bytes big-endian, into an image held in 
+*       memory.
+*
+*       In/Out Expectations: expects the length bytes that follow a header 
+*       in the format of the layout, the layout, and a valid image with the
+*       width and height of the header. Returns true once every pixel of the
+*       image is set, or false, leaving the image untouched, if the input is
+*       too short to hold every word.
+*/
+bool layout_to_image(const unsigned char *input, size_t length, 
+                     word_layout layout, arith40_image image) {
+        unsigned columns = image->width / BLOCK_SIZE;
+        unsigned rows = image->height / BLOCK_SIZE;
+        size_t word_bytes = layout->word_bits / CHAR_BITS;
+        if (length / word_bytes < (size_t)columns * rows) {
+                return false;
+        }
+
+        for (unsigned col = 0; col < columns; col++) {
+                for (unsigned row = 0; row < rows; row++) {
+                        const unsigned char *bytes = input + word_bytes * 
+                                ((size_t)col * rows + row);
+                        uint64_t word = 0;
+                        for (size_t k = 0; k < word_bytes; k++) {
+                                word = word << CHAR_BITS | bytes[k];
+                        }
+                        layout_word_to_image(layout, word, image, col, row);
+                }
+        }
+        return true;
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+*       buffer40.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the declarations of the functions that compress
+*       an image held in memory into a buffer the client provides, and 
+*       decompress a buffer back into an image held in memory, without any
+*       files and without allocating memory.
+*   
+******************************************************************************/
+
+#ifndef BUFFER40_
+#define BUFFER40_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/*
+ * An image held in memory by the client: height rows of width pixels, each
+ * pixel its red, green and blue samples, each sample one byte if maxval is
+ * below 256 and otherwise two bytes, most significant first (the layout of
+ * a binary ppm raster). stride is the number of bytes from the start of 
+ * one row to the start of the next.
+ */
+typedef struct arith40_image {
+        unsigned char *pixels;
+        unsigned width, height;
+        size_t stride;
+        unsigned maxval;
+} *arith40_image;
+
+/*
+ * The number of bytes compress40_buffer writes for an image of the given 
+ * size; a last odd row or column is dropped, like compress40 does
+ */
+size_t compress40_length(unsigned width, unsigned height);
+
+/*
+ * Compresses an image into length bytes of output, writing the same bytes 
+ * compress40 would; returns the number of bytes written, or 0 if they do 
+ * not fit
+ */
+size_t compress40_buffer(arith40_image image, unsigned char *output, 
+                         size_t length);
+
+/*
+ * Reads the size of the image held in length bytes of input; returns false
+ * if the input does not start with a valid header
+ */
+bool decompress40_size(const unsigned char *input, size_t length, 
+                       unsigned *width, unsigned *height);
+
+/*
+ * Decompresses length bytes of input, in any format, into an image of
+ * the size decompress40_size gives, at the maxval the client chooses; 
+ * the pixels are the ones decompress40_with writes at that maxval.
+ * Returns false, leaving the image untouched, if the header is not valid, 
+ * the size differs or the input is too short
+ */
+bool decompress40_buffer(const unsigned char *input, size_t length,
+                         arith40_image image);
+
+#endif
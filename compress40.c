@@ -7,137 +7,1397 @@
 *   
 *       This file contains the functions necessary to compress an image or 
 *       decompress a compressed image from a given file from the user (parsed 
-*       in 40image.c), as well as trim the original image if it has an odd 
-*       width/height
+*       in 40image.c). If the original image has an odd width/height, its 
+*       last column/row is skipped in place rather than copied away. The 
+*       fused functions read and write ppm files themselves, holding the 
+*       pixels as one raster of bytes; libpnm is only used by the staged 
+*       pipeline they are checked against.
 *   
 ******************************************************************************/
 
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
 #include <a2methods.h>
 #include "assert.h"
 #include "pnm.h"
 #include "a2blocked.h"
 #include "uarray2b.h"
+#include "arena40.h"
 #include "compress40.h"
 #include "cv_rgb.h"
 #include "unpacked_cv.h"
 #include "word_unpacked.h"
 #include "file_word.h"
+#include "word_rgb.h"
+#include "word_layout.h"
+#include "file_rgb.h"
+#include "file_tile.h"
+#include "async40.h"
+
+#define BLOCK_SIZE 2
+#define ONE_BYTE_DENOMINATOR 255
+#define MAX_DENOMINATOR 65535
+
+/* a word of a wider layout is stored as two words of 32 bits, high first */
+#define HALF_BITS 32
+
+/* 
+ * struct arith40_buffers
+ *      Buffers that one compression or decompression at a time can reuse 
+ *      from one image to the next: an array of words, an array of the 
+ *      64 bit words of a wider layout, two rows of pixels and the bytes of
+ *      a whole image, each grown when an image needs more than it holds.
+ */
+struct arith40_buffers {
+        uint32_t *words;
+        size_t words_length;
+        uint64_t *wide_words;
+        size_t wide_words_length;
+        struct Pnm_rgb *rows;
+        size_t rows_length;
+        unsigned char *bytes;
+        size_t bytes_length;
+};
+
+/* 
+ * libpnm is not known to be thread safe (and may use the CII exception 
+ * stack, which is shared by all threads), so calls into it are serialized
+ */
+static pthread_mutex_t pnm_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* 
+ * struct band
+ *      A struct that holds the work of one compression thread: the image, 
+ *      the block rows [first_row, end_row) it converts, and the array of 
+ *      words for the whole image that it fills its part of.
+ */
+struct band {
+        arith40_image image;
+        unsigned first_row, end_row;
+        uint32_t *words;
+};
+
+/* 
+ * struct columns
+ *      A struct that holds the work of one decompression thread: the image,
+ *      the block columns [first_col, end_col) it converts, and where their 
+ *      words come from. Either words holds the words of the whole image, or
+ *      it is NULL and the thread converts its own columns straight from the
+ *      mapped file of reader.
+ */
+struct columns {
+        arith40_image image;
+        unsigned first_col, end_col;
+        uint32_t *words;
+        word_reader reader;
+};
+
+/* 
+ * struct tiles
+ *      A struct that holds the work of one thread converting tiles: the 
+ *      image, the index of its tiles, the tiles [first_tile, end_tile) it
+ *      converts, and the words of every tile, in the order tile_at lays 
+ *      them out, which compression fills. valid is cleared if a tile being
+ *      decompressed fails its check.
+ */
+struct tiles {
+        arith40_image image;
+        tile_index index;
+        size_t first_tile, end_tile;
+        uint32_t *words;
+        bool valid;
+};
 
 /******** HELPER FUNCTIONS ********/
-Pnm_ppm make_even(Pnm_ppm image);
-void copy_pixmap(int i, int j, A2Methods_UArray2 array2, 
-                     A2Methods_Object *rgb, void *image);
+void compress_serial(FILE *input, FILE *output, arith40_buffers buffers);
+void compress_bands(FILE *input, FILE *output, unsigned threads, 
+                    arith40_buffers buffers);
+void *compress_band(void *band);
+void bands_to_words(arith40_image image, unsigned threads, uint32_t *words);
+void compress_whole(FILE *input, FILE *output, unsigned format, 
+                    unsigned threads, arith40_buffers buffers);
+void compress_stream(FILE *input, FILE *output, arith40_buffers buffers);
+void compress_layout(FILE *input, FILE *output, word_layout layout, 
+                     arith40_buffers buffers);
+void compress_tiles(FILE *input, FILE *output, unsigned threads, 
+                    arith40_buffers buffers);
+void *compress_tile_range(void *tiles);
+void decompress_serial(word_reader reader, FILE *output, unsigned maxval,
+                       arith40_buffers buffers);
+void decompress_parallel(word_reader reader, FILE *output, unsigned maxval,
+                         unsigned threads, arith40_buffers buffers);
+void *decompress_columns(void *columns);
+void decompress_layout(word_reader reader, FILE *output, unsigned maxval,
+                       arith40_buffers buffers);
+void decompress_rows(word_reader reader, FILE *output, unsigned maxval,
+                     arith40_buffers buffers);
+void decompress_tiles(word_reader reader, FILE *output, unsigned maxval,
+                      unsigned threads, arith40_buffers buffers);
+void *decompress_tile_range(void *tiles);
+void decompress_region(word_reader reader, FILE *output, unsigned maxval,
+                       arith40_region region, arith40_buffers buffers);
+void decompress_thumbnail(word_reader reader, FILE *output, unsigned maxval,
+                          arith40_buffers buffers);
+void region_blocks(word_reader reader, tile window, arith40_image image, 
+                   arith40_buffers buffers);
+void region_tiles(word_reader reader, tile window, arith40_image image);
+void region_layout(word_reader reader, tile window, arith40_image image, 
+                   arith40_buffers buffers);
+void halves_to_wide_words(const uint32_t *halves, unsigned count, 
+                          uint64_t *words);
+bool run_tiles(arith40_image image, tile_index index, uint32_t *words, 
+               unsigned threads, void *(*convert)(void *));
+void read_image(FILE *input, arith40_buffers buffers, arith40_image image);
+void new_image(arith40_buffers buffers, unsigned width, unsigned height, 
+               unsigned maxval, arith40_image image);
+Pnm_ppm read_rgb_image(FILE *input);
+void write_rgb_image(FILE *output, Pnm_ppm image);
+void close_async_file(FILE *wrapper, FILE *file);
+uint32_t *buffer_words(arith40_buffers buffers, size_t count);
+uint64_t *buffer_wide_words(arith40_buffers buffers, size_t count);
+struct Pnm_rgb *buffer_rows(arith40_buffers buffers, unsigned width);
+unsigned char *buffer_bytes(arith40_buffers buffers, size_t length);
                      
 
 /*
-*       Description: A function that reads a Pnm_ppm from an input file
-*       and writes a header and chars associated with the Pnm_ppm pixels 
-*       values to standard output. 
+*       Description: A function that reads a ppm from an input file and 
+*       writes its compressed image to standard output.
 *
 *       In/Out Expectations: expects to take in a valid ppm type input file.
-*       After writing to standard output frees all memory associated with 
-*       the structs made to preform the compression. No return value.
+*       No return value.
 */
 void compress40  (FILE *input) {
+        compress40_with(input, stdout, NULL);
+}
+
+/*
+*       Description: A function that reads a compressed image from an input
+*       file and writes it as a ppm to standard output.
+*
+*       In/Out Expectations: expects to take in a valid input file with
+*       formatted header and characters as specified in the Arith40 spec, or
+*       in the row by row format. Returns nothing.
+*/
+void decompress40(FILE *input){
+        decompress40_with(input, stdout, NULL);
+}
+
+/*
+*       Description: A function that reads a ppm from an input file and 
+*       writes its compressed image to an output file, the way the options
+*       ask for: on one thread, split across several threads, two rows at a
+*       time, or in tiles, and with the files read and written on threads of
+*       their own if the options ask for it. Without options, it compresses
+*       on one thread like compress40.
+*
+*       In/Out Expectations: expects to take in a valid ppm type input file
+*       (binary, if streaming), an output file open for writing, and options
+*       or NULL. The buffers of the options are reused if given, otherwise 
+*       the buffers are freed before returning. The output file is flushed
+*       if the files were read and written on their own threads. Either 
+*       way, a failed write leaves the error indicator of the output file 
+*       set. No return value.
+*/
+void compress40_with(FILE *input, FILE *output, arith40_options options) {
         assert(input != NULL);
+        assert(output != NULL);
 
-        A2Methods_T methods = uarray2_methods_blocked;
-        Pnm_ppm image = Pnm_ppmread(input, methods);
-        assert(image != NULL);
-        
-        image = make_even(image);
+        struct arith40_options defaults = ARITH40_DEFAULT_OPTIONS;
+        if (options == NULL) {
+                options = &defaults;
+        }
+        arith40_buffers buffers = options->buffers;
+        if (buffers == NULL) {
+                buffers = new_arith40_buffers();
+        }
+        FILE *file_input = input;
+        FILE *file_output = output;
+        if (options->async) {
+                input = open_async_input(input);
+                output = open_async_output(output);
+        }
 
-        cv_pixmap cv_image = rgb_to_cv_pixmap(image);
-        unpacked_pixmap unpacked_image = cv_to_unpacked_pixmap(cv_image);
-        word_pixmap packed_image = unpacked_to_word_pixmap(unpacked_image);
-        write_to_file(packed_image);
- 
-        free_cv_pixmap(cv_image);
-        free_unpacked_pixmap(unpacked_image);
-        free_word_pixmap(packed_image);
-        Pnm_ppmfree(&image);
+        if (options->layout != NULL && options->layout != &standard_layout) {
+                assert(!options->stream && !options->tiled && 
+                       !options->entropy && !options->progressive);
+                compress_layout(input, output, options->layout, buffers);
+        } else if (options->stream) {
+                compress_stream(input, output, buffers);
+        } else if (options->tiled) {
+                compress_tiles(input, output, options->threads, buffers);
+        } else if (options->entropy) {
+                compress_whole(input, output, FORMAT_ENTROPY, 
+                               options->threads, buffers);
+        } else if (options->progressive) {
+                compress_whole(input, output, FORMAT_PROGRESSIVE, 
+                               options->threads, buffers);
+        } else if (options->threads < 2) {
+                compress_serial(input, output, buffers);
+        } else {
+                compress_bands(input, output, options->threads, buffers);
+        }
+
+        if (options->async) {
+                close_async_file(input, file_input);
+                close_async_file(output, file_output);
+        }
 
+        if (options->buffers == NULL) {
+                free_arith40_buffers(&buffers);
+        }
 }
 
 /*
-*       Description: A function that reads a header and characters from a file
-*       and converts this data to a Pnm_ppm, which is read to standard output.
+*       Description: A function that reads a compressed image from an input
+*       file and writes it as a ppm to an output file, at the maxval the 
+*       options ask for, splitting the work across threads and reading and 
+*       writing the files on threads of their own if they ask for it. A file
+*       that is mapped into memory is not read on its own thread, since it 
+*       is never read with fread. Without options, it decompresses on one 
+*       thread at CHOSEN_DENOMINATOR like decompress40.
 *
 *       In/Out Expectations: expects to take in a valid input file with
-*       formatted header and characters as specified in the Arith40 spec. Frees
-*       all memory associated with the Pnm_ppm. Returns nothing.
+*       formatted header and characters as specified in the Arith40 spec, or
+*       in the row by row format, an output file open for writing, and 
+*       options or NULL, whose maxval is at most MAX_DENOMINATOR. The 
+*       buffers of the options are reused if given, otherwise the buffers 
+*       are freed before returning. The output file is flushed if it was 
+*       written on its own thread. Either way, a failed write leaves the 
+*       error indicator of the output file set. Returns nothing.
 */
-void decompress40(FILE *input){
+void decompress40_with(FILE *input, FILE *output, arith40_options options) {
         assert(input != NULL);
+        assert(output != NULL);
+
+        struct arith40_options defaults = ARITH40_DEFAULT_OPTIONS;
+        if (options == NULL) {
+                options = &defaults;
+        }
+        arith40_buffers buffers = options->buffers;
+        if (buffers == NULL) {
+                buffers = new_arith40_buffers();
+        }
+        unsigned maxval = options->maxval;
+        if (maxval == 0) {
+                maxval = CHOSEN_DENOMINATOR;
+        }
+        assert(maxval <= MAX_DENOMINATOR);
+
+        struct word_reader reader;
+        open_word_reader(&reader, input);
+        if (options->async && reader.mapping == NULL) {
+                reader.input = open_async_input(input);
+        }
+        FILE *file_output = output;
+        if (options->async) {
+                output = open_async_output(output);
+        }
+
+        if (options->thumbnail) {
+                decompress_thumbnail(&reader, output, maxval, buffers);
+        } else if (options->region != NULL) {
+                decompress_region(&reader, output, maxval, options->region,
+                                  buffers);
+        } else if (reader.format == FORMAT_FINE) {
+                decompress_layout(&reader, output, maxval, buffers);
+        } else if (reader.format == FORMAT_ROWS) {
+                decompress_rows(&reader, output, maxval, buffers);
+        } else if (reader.format == FORMAT_TILES) {
+                decompress_tiles(&reader, output, maxval, options->threads,
+                                 buffers);
+        } else if (options->threads < 2 || 
+                   reader.format == FORMAT_ENTROPY) {
+                decompress_serial(&reader, output, maxval, buffers);
+        } else {
+                decompress_parallel(&reader, output, maxval, 
+                                    options->threads, buffers);
+        }
+
+        close_word_reader(&reader);
+        if (reader.input != input) {
+                close_async_file(reader.input, input);
+        }
+        if (options->async) {
+                close_async_file(output, file_output);
+        }
+
+        if (options->buffers == NULL) {
+                free_arith40_buffers(&buffers);
+        }
+}
+
+/*
+*       Description: A function that reads a ppm image from an input file
+*       and writes a header and chars associated with its pixels values to 
+*       an output file. Each block column is converted straight to words and
+*       written before the next one is touched, so the only memory used 
+*       besides the image is one column of words. A last odd row or column 
+*       is never read, so the image is not copied to trim it.
+*
+*       In/Out Expectations: expects to take in a valid binary or plain ppm
+*       type input file, an output file open for writing, and buffers to 
+*       take the image and the column of words from. No return value.
+*/
+void compress_serial(FILE *input, FILE *output, arith40_buffers buffers) {
+        struct arith40_image image;
+        read_image(input, buffers, &image);
+
+        unsigned columns = image.width / BLOCK_SIZE;
+        unsigned rows = image.height / BLOCK_SIZE;
+        uint32_t *words = buffer_words(buffers, rows);
+
+        struct word_writer writer;
+        write_header(output, FORMAT_COLUMNS, columns * BLOCK_SIZE, 
+                     rows * BLOCK_SIZE);
+        open_word_writer(&writer, output);
+        for (unsigned col = 0; col < columns; col++) {
+                image_to_word_column(&image, col, words);
+                writer_words(&writer, words, rows);
+        }
+        close_word_writer(&writer);
+}
+
+/*
+*       Description: A function that compresses like compress_serial, but 
+*       converts the image to words on as many threads as it is given (see
+*       bands_to_words). The words are written once every band is done, in
+*       the same order compress_serial writes them.
+*
+*       In/Out Expectations: expects to take in a valid binary or plain ppm
+*       type input file, an output file open for writing, the number of 
+*       threads to use and buffers to take the image and its words from. 
+*       Writes exactly the same bytes as compress_serial. No return value.
+*/
+void compress_bands(FILE *input, FILE *output, unsigned threads, 
+                    arith40_buffers buffers) {
+        struct arith40_image image;
+        read_image(input, buffers, &image);
+
+        unsigned columns = image.width / BLOCK_SIZE;
+        unsigned rows = image.height / BLOCK_SIZE;
+        uint32_t *words = buffer_words(buffers, (size_t)columns * rows);
+        bands_to_words(&image, threads, words);
+
+        write_header(output, FORMAT_COLUMNS, columns * BLOCK_SIZE, 
+                     rows * BLOCK_SIZE);
+        write_words(output, words, columns * rows);
+}
+
+/*
+*       Description: A function that converts an image to words, in the 
+*       order of format 2, splitting it into horizontal bands of block rows
+*       and converting each band on its own thread.
+*
+*       In/Out Expectations: expects a valid image, the number of threads 
+*       to use, and an array with room for a word per block. No return 
+*       value.
+*/
+void bands_to_words(arith40_image image, unsigned threads, uint32_t *words) {
+        unsigned rows = image->height / BLOCK_SIZE;
+        if (threads > rows) {
+                threads = rows > 0 ? rows : 1;
+        }
+        if (threads < 1) {
+                threads = 1;
+        }
+
+        pthread_t workers[threads];
+        struct band bands[threads];
+        for (unsigned t = 0; t < threads; t++) {
+                bands[t].image = image;
+                bands[t].first_row = (uint64_t)rows * t / threads;
+                bands[t].end_row = (uint64_t)rows * (t + 1) / threads;
+                bands[t].words = words;
+        }
+        if (threads == 1) {
+                compress_band(&bands[0]);
+                return;
+        }
+
+        for (unsigned t = 0; t < threads; t++) {
+                int error = pthread_create(&workers[t], NULL, compress_band,
+                                           &bands[t]);
+                assert(error == 0);
+        }
+        for (unsigned t = 0; t < threads; t++) {
+                pthread_join(workers[t], NULL);
+        }
+}
+
+/*
+*       Description: The function each compression thread runs. Converts 
+*       the block rows of its band to words.
+*
+*       In/Out Expectations: expects a pointer to a struct band, which is
+*       not shared with any other thread. Returns NULL.
+*/
+void *compress_band(void *band) {
+        struct band *curr_band = band;
+        image_to_word_band(curr_band->image, curr_band->first_row, 
+                           curr_band->end_row, curr_band->words);
+        return NULL;
+}
+
+/*
+*       Description: A function that compresses a ppm image to a format 
+*       that needs every word before it can write any: the image is 
+*       converted to words on as many threads as it is given, then the 
+*       words are entropy coded, one field at a time (format 5), or split 
+*       into their coarse and detail fields (format 6) as they are written.
+*
+*       In/Out Expectations: expects to take in a valid binary or plain ppm
+*       type input file, an output file open for writing, the format to 
+*       write, FORMAT_ENTROPY or FORMAT_PROGRESSIVE, the number of threads 
+*       to use and buffers to take the image and its words from. A last odd
+*       row or column is ignored, like it is by compress_serial. No return 
+*       value.
+*/
+void compress_whole(FILE *input, FILE *output, unsigned format, 
+                    unsigned threads, arith40_buffers buffers) {
+        assert(format == FORMAT_ENTROPY || format == FORMAT_PROGRESSIVE);
+        struct arith40_image image;
+        read_image(input, buffers, &image);
+
+        unsigned columns = image.width / BLOCK_SIZE;
+        unsigned rows = image.height / BLOCK_SIZE;
+        uint32_t *words = buffer_words(buffers, (size_t)columns * rows);
+        bands_to_words(&image, threads, words);
+
+        write_header(output, format, columns * BLOCK_SIZE, 
+                     rows * BLOCK_SIZE);
+        if (format == FORMAT_ENTROPY) {
+                write_entropy(output, words, (size_t)columns * rows);
+        } else {
+                write_progressive(output, words, (size_t)columns * rows);
+        }
+}
+
+/*
+*       Description: A function that reads a ppm image from an input file 
+*       and writes it to an output file as the words of a layout wider than
+*       the standard one, column by column like compress_serial, each word 
+*       packed with the kernel of the layout and written as two words of 32
+*       bits, the high one first.
+*
+*       In/Out Expectations: expects to take in a valid binary or plain ppm
+*       type input file, an output file open for writing, a layout of 64 
+*       bit words, and buffers to take the image, the halves of a column 
+*       of words and the column of words from. No return value.
+*/
+void compress_layout(FILE *input, FILE *output, word_layout layout, 
+                     arith40_buffers buffers) {
+        assert(layout != NULL && layout->word_bits == 2 * HALF_BITS);
+        struct arith40_image image;
+        read_image(input, buffers, &image);
+
+        unsigned columns = image.width / BLOCK_SIZE;
+        unsigned rows = image.height / BLOCK_SIZE;
+        uint32_t *halves = buffer_words(buffers, 2 * (size_t)rows);
+        uint64_t *words = buffer_wide_words(buffers, rows);
+
+        struct word_writer writer;
+        write_header(output, layout->format, columns * BLOCK_SIZE, 
+                     rows * BLOCK_SIZE);
+        open_word_writer(&writer, output);
+        for (unsigned col = 0; col < columns; col++) {
+                image_to_layout_column(layout, &image, col, words);
+                for (unsigned row = 0; row < rows; row++) {
+                        halves[2 * row] = words[row] >> HALF_BITS;
+                        halves[2 * row + 1] = (uint32_t)words[row];
+                }
+                writer_words(&writer, halves, 2 * rows);
+        }
+        close_word_writer(&writer);
+}
+
+/*
+*       Description: A function that compresses a binary ppm file two rows of
+*       pixels at a time, writing each row of blocks before reading the next
+*       two rows, so memory use depends on the width of the image but not on
+*       its height. The words are written in the row by row format.
+*
+*       In/Out Expectations: expects to take in a valid binary (P6) ppm type
+*       input file, an output file open for writing, and buffers to take 
+*       the rows of pixels and words from. A last odd row or column is 
+*       ignored, like it is by compress_serial. No return value.
+*/
+void compress_stream(FILE *input, FILE *output, arith40_buffers buffers) {
+        unsigned width, height, denominator;
+        unsigned kind = read_ppm_header(input, &width, &height, &denominator);
+        assert(kind == PPM_RAW);
+
+        unsigned columns = width / BLOCK_SIZE;
+        unsigned rows = height / BLOCK_SIZE;
+        struct Pnm_rgb *top = buffer_rows(buffers, width);
+        struct Pnm_rgb *bottom = top + width;
+        uint32_t *words = buffer_words(buffers, columns);
+
+        struct word_writer writer;
+        write_header(output, FORMAT_ROWS, columns * BLOCK_SIZE, 
+                     rows * BLOCK_SIZE);
+        open_word_writer(&writer, output);
+        for (unsigned row = 0; row < rows; row++) {
+                read_ppm_row(input, width, denominator, top);
+                read_ppm_row(input, width, denominator, bottom);
+                rgb_to_word_row(top, bottom, columns, denominator, words);
+                writer_words(&writer, words, columns);
+        }
+        close_word_writer(&writer);
+}
+
+/*
+*       Description: A function that compresses a ppm image to tiles 
+*       (format 4), converting the tiles on as many threads as it is given,
+*       then writes the header, the index of the tiles and their words.
+*
+*       In/Out Expectations: expects to take in a valid binary or plain ppm
+*       type input file, an output file open for writing, the number of 
+*       threads to use and buffers to take the image and its words from. A
+*       last odd row or column is ignored, like it is by compress_serial. No
+*       return value.
+*/
+void compress_tiles(FILE *input, FILE *output, unsigned threads, 
+                    arith40_buffers buffers) {
+        struct arith40_image image;
+        read_image(input, buffers, &image);
+
+        unsigned columns = image.width / BLOCK_SIZE;
+        unsigned rows = image.height / BLOCK_SIZE;
+        struct tile_index index;
+        layout_tiles(&index, columns, rows, TILE_BLOCKS);
+        uint32_t *words = buffer_words(buffers, (size_t)columns * rows);
+        run_tiles(&image, &index, words, threads, compress_tile_range);
+
+        write_header(output, FORMAT_TILES, columns * BLOCK_SIZE, 
+                     rows * BLOCK_SIZE);
+        write_tile_index(output, &index, words);
+        write_words(output, words, columns * rows);
+}
+
+/*
+*       Description: The function each thread compressing tiles runs. 
+*       Converts each of its tiles to words, where tile_at lays them out.
+*
+*       In/Out Expectations: expects a pointer to a struct tiles, which is
+*       not shared with any other thread. Returns NULL.
+*/
+void *compress_tile_range(void *tiles) {
+        struct tiles *range = tiles;
+
+        for (size_t k = range->first_tile; k < range->end_tile; k++) {
+                struct tile curr_tile;
+                tile_at(range->index, k, &curr_tile);
+                image_to_word_tile(range->image, &curr_tile, range->words + 
+                                   curr_tile.offset / sizeof(uint32_t));
+        }
+        return NULL;
+}
+
+/*
+*       Description: A function that reads the words that follow a header and
+*       converts them to an image, which is written to an output file as a 
+*       binary ppm. Each block column of words is read and converted straight
+*       to pixels, so no intermediate pixmaps are built.
+*
+*       In/Out Expectations: expects an open word_reader, an output file 
+*       open for writing, the maxval to write the image with, and buffers 
+*       to take the column of words and the image from. Writes exactly the 
+*       same bytes as Pnm_ppmwrite would. Returns nothing.
+*/
+void decompress_serial(word_reader reader, FILE *output, unsigned maxval,
+                       arith40_buffers buffers) {
+        unsigned columns = reader->width / BLOCK_SIZE;
+        unsigned rows = reader->height / BLOCK_SIZE;
+        struct arith40_image image;
+        new_image(buffers, columns * BLOCK_SIZE, rows * BLOCK_SIZE, maxval, 
+                  &image);
+        uint32_t *words = buffer_words(buffers, rows);
+
+        for (unsigned col = 0; col < columns; col++) {
+                reader_words(reader, words, rows);
+                word_column_to_image(words, &image, col);
+        }
+        write_ppm_header(output, image.width, image.height, image.maxval);
+        write_ppm_pixels(output, &image);
+}
+
+/*
+*       Description: A function that decompresses like decompress_serial 
+*       the words of a layout wider than the standard one, the layout given
+*       by the format of the file, each word read as two words of 32 bits, 
+*       the high one first, and unpacked with the kernel of the layout.
+*
+*       In/Out Expectations: expects an open word_reader of a file whose 
+*       format is that of a layout of 64 bit words, an output file open for
+*       writing, the maxval to write the image with, and buffers to take the
+*       halves of a column of words, the column of words and the image 
+*       from. Returns nothing.
+*/
+void decompress_layout(word_reader reader, FILE *output, unsigned maxval,
+                       arith40_buffers buffers) {
+        word_layout layout = format_to_layout(reader->format);
+        assert(layout->word_bits == 2 * HALF_BITS);
+        unsigned columns = reader->width / BLOCK_SIZE;
+        unsigned rows = reader->height / BLOCK_SIZE;
+        struct arith40_image image;
+        new_image(buffers, columns * BLOCK_SIZE, rows * BLOCK_SIZE, maxval, 
+                  &image);
+        uint32_t *halves = buffer_words(buffers, 2 * (size_t)rows);
+        uint64_t *words = buffer_wide_words(buffers, rows);
+
+        for (unsigned col = 0; col < columns; col++) {
+                reader_words(reader, halves, 2 * rows);
+                halves_to_wide_words(halves, rows, words);
+                layout_column_to_image(layout, words, &image, col);
+        }
+        write_ppm_header(output, image.width, image.height, image.maxval);
+        write_ppm_pixels(output, &image);
+}
+
+/*
+*       Description: A function that decompresses like decompress_serial, 
+*       but splits the words into ranges of block columns and converts each 
+*       range to pixels on its own thread. Every word is four bytes, so the
+*       offset of any column is known from the header: when the input is 
+*       mapped, each thread converts its own columns straight from the 
+*       mapping, otherwise all words are read first and shared.
+*
+*       In/Out Expectations: expects an open word_reader, an output file 
+*       open for writing, the maxval to write the image with, the number of
+*       threads to use, and buffers to take the words and the image from. 
+*       Writes exactly the same bytes as decompress_serial. Returns nothing.
+*/
+void decompress_parallel(word_reader reader, FILE *output, unsigned maxval,
+                         unsigned threads, arith40_buffers buffers) {
+        unsigned columns = reader->width / BLOCK_SIZE;
+        unsigned rows = reader->height / BLOCK_SIZE;
+        struct arith40_image image;
+        new_image(buffers, columns * BLOCK_SIZE, rows * BLOCK_SIZE, maxval, 
+                  &image);
+        if (threads > columns) {
+                threads = columns > 0 ? columns : 1;
+        }
+
+        uint32_t *words = NULL;
+        if (reader->words == NULL) {
+                words = buffer_words(buffers, (size_t)columns * rows);
+                reader_words(reader, words, columns * rows);
+        }
+
+        pthread_t workers[threads];
+        struct columns ranges[threads];
+        for (unsigned t = 0; t < threads; t++) {
+                ranges[t].image = &image;
+                ranges[t].first_col = (uint64_t)columns * t / threads;
+                ranges[t].end_col = (uint64_t)columns * (t + 1) / threads;
+                ranges[t].words = words;
+                ranges[t].reader = reader;
+                int error = pthread_create(&workers[t], NULL, 
+                                           decompress_columns, &ranges[t]);
+                assert(error == 0);
+        }
+        for (unsigned t = 0; t < threads; t++) {
+                pthread_join(workers[t], NULL);
+        }
+        write_ppm_header(output, image.width, image.height, image.maxval);
+        write_ppm_pixels(output, &image);
+}
+
+/*
+*       Description: The function each decompression thread runs. Converts
+*       the words of its block columns to pixels, reading them from the file
+*       one column at a time if they have not been read already.
+*
+*       In/Out Expectations: expects a pointer to a struct columns, which is
+*       not shared with any other thread. Returns NULL.
+*/
+void *decompress_columns(void *columns) {
+        struct columns *range = columns;
+        unsigned rows = range->image->height / BLOCK_SIZE;
+        uint32_t *column_words = range->words;
+
+        if (range->words == NULL) {
+                column_words = malloc((rows + 1) * sizeof(*column_words));
+                assert(column_words != NULL);
+        }
+        for (unsigned col = range->first_col; col < range->end_col; col++) {
+                if (range->words == NULL) {
+                        reader_words_at(range->reader, (size_t)col * rows, 
+                                        column_words, rows);
+                        word_column_to_image(column_words, range->image, 
+                                             col);
+                } else {
+                        word_column_to_image(range->words + 
+                                             (size_t)col * rows, 
+                                             range->image, col);
+                }
+        }
+        if (range->words == NULL) {
+                free(column_words);
+        }
+        return NULL;
+}
+
+/*
+*       Description: A function that decompresses the words of a file in the
+*       row by row format, writing the two rows of pixels of each block row
+*       to an output file as soon as the block row is read, so the first 
+*       rows are out before the last words are read and only two rows of
+*       pixels are ever in memory.
+*
+*       In/Out Expectations: expects an open word_reader, an output file 
+*       open for writing, the maxval to write the image with, and buffers 
+*       to take the rows of pixels and words from. Writes exactly the same 
+*       bytes as Pnm_ppmwrite would for the whole image. Returns nothing.
+*/
+void decompress_rows(word_reader reader, FILE *output, unsigned maxval,
+                     arith40_buffers buffers) {
+        unsigned columns = reader->width / BLOCK_SIZE;
+        unsigned rows = reader->height / BLOCK_SIZE;
+        unsigned width = columns * BLOCK_SIZE;
+        struct Pnm_rgb *top = buffer_rows(buffers, width);
+        struct Pnm_rgb *bottom = top + width;
+        uint32_t *words = buffer_words(buffers, columns);
+
+        write_ppm_header(output, width, rows * BLOCK_SIZE, maxval);
+        for (unsigned row = 0; row < rows; row++) {
+                reader_words(reader, words, columns);
+                word_row_to_rgb(words, columns, maxval, top, bottom);
+                write_ppm_row(output, top, width, maxval);
+                write_ppm_row(output, bottom, width, maxval);
+                fflush(output);
+        }
+}
+
+/*
+*       Description: A function that decompresses a tiled file (format 4). 
+*       The file is mapped, or else loaded, into memory, so each tile can be
+*       found from the index, checked against its CRC and converted to 
+*       pixels on its own, on as many threads as it is given.
+*
+*       In/Out Expectations: expects an open word_reader of a tiled file, an
+*       output file open for writing, the maxval to write the image with, 
+*       the number of threads to use, and buffers to take the image from. 
+*       Asserts that the index and every tile are valid. Returns nothing.
+*/
+void decompress_tiles(word_reader reader, FILE *output, unsigned maxval,
+                      unsigned threads, arith40_buffers buffers) {
+        load_word_reader(reader);
+        struct tile_index index;
+        size_t index_length = bytes_to_tile_index(reader->words, 
+                reader->length, reader->width, reader->height, &index);
+        assert(index_length > 0);
+
+        struct arith40_image image;
+        new_image(buffers, index.columns * BLOCK_SIZE, 
+                  index.rows * BLOCK_SIZE, maxval, &image);
+        bool valid = run_tiles(&image, &index, NULL, threads, 
+                               decompress_tile_range);
+        assert(valid);
+
+        write_ppm_header(output, image.width, image.height, image.maxval);
+        write_ppm_pixels(output, &image);
+}
+
+/*
+*       Description: The function each thread decompressing tiles runs. 
+*       Checks each of its tiles and converts its words to pixels.
+*
+*       In/Out Expectations: expects a pointer to a struct tiles, which is
+*       not shared with any other thread, whose index was read from memory.
+*       Clears valid if a tile fails its check. Returns NULL.
+*/
+void *decompress_tile_range(void *tiles) {
+        struct tiles *range = tiles;
+
+        for (size_t k = range->first_tile; k < range->end_tile; k++) {
+                struct tile curr_tile;
+                if (!index_to_tile(range->index, k, &curr_tile)) {
+                        range->valid = false;
+                        continue;
+                }
+                word_tile_to_image(range->index->data + curr_tile.offset, 
+                                   &curr_tile, range->image, NULL);
+        }
+        return NULL;
+}
+
+/*
+*       Description: A function that decompresses only a region of an 
+*       image, in any format, and writes just that region as a ppm. Only the
+*       blocks covering the region are converted, into an image as big as 
+*       they are, and the words of those blocks are found from their offsets
+*       (or, for tiles, from the index), so the work done is proportional to
+*       the region, not the image. A mapped file is only read where those 
+*       words are; any other file is loaded into memory first.
+*
+*       In/Out Expectations: expects an open word_reader, an output file 
+*       open for writing, the maxval to write the image with, a region of 
+*       the image, which is clipped to the image, and buffers to take the 
+*       image and words from. Returns nothing.
+*/
+void decompress_region(word_reader reader, FILE *output, unsigned maxval,
+                       arith40_region region, arith40_buffers buffers) {
+        unsigned width = reader->width / BLOCK_SIZE * BLOCK_SIZE;
+        unsigned height = reader->height / BLOCK_SIZE * BLOCK_SIZE;
+        struct arith40_region crop = *region;
+        if (crop.x > width) {
+                crop.x = width;
+        }
+        if (crop.y > height) {
+                crop.y = height;
+        }
+        if (crop.width > width - crop.x) {
+                crop.width = width - crop.x;
+        }
+        if (crop.height > height - crop.y) {
+                crop.height = height - crop.y;
+        }
+
+        struct tile window;
+        window.first_col = crop.x / BLOCK_SIZE;
+        window.first_row = crop.y / BLOCK_SIZE;
+        window.end_col = (crop.x + crop.width + 1) / BLOCK_SIZE;
+        window.end_row = (crop.y + crop.height + 1) / BLOCK_SIZE;
+        struct arith40_image image;
+        new_image(buffers, (window.end_col - window.first_col) * BLOCK_SIZE,
+                  (window.end_row - window.first_row) * BLOCK_SIZE, maxval,
+                  &image);
 
-        word_pixmap word_image = read_from_file(input);
-        unpacked_pixmap unpacked_image = word_to_unpacked_pixmap(word_image);
-        cv_pixmap cv_image = unpacked_to_cv_pixmap(unpacked_image);
-        Pnm_ppm rgb_image = cv_to_rgb_pixmap(cv_image);
-        Pnm_ppmwrite(stdout, rgb_image);
+        load_word_reader(reader);
+        if (reader->format == FORMAT_TILES) {
+                region_tiles(reader, &window, &image);
+        } else if (reader->format == FORMAT_FINE) {
+                region_layout(reader, &window, &image, buffers);
+        } else {
+                region_blocks(reader, &window, &image, buffers);
+        }
 
-        free_word_pixmap(word_image);
-        free_unpacked_pixmap(unpacked_image);
-        free_cv_pixmap(cv_image);
-        Pnm_ppmfree(&rgb_image);
+        size_t sample_bytes = maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        struct arith40_image view = image;
+        view.pixels += (crop.y - window.first_row * BLOCK_SIZE) * 
+                       image.stride + 
+                       (crop.x - window.first_col * BLOCK_SIZE) * 3 * 
+                       sample_bytes;
+        view.width = crop.width;
+        view.height = crop.height;
+        write_ppm_header(output, view.width, view.height, view.maxval);
+        write_ppm_pixels(output, &view);
 }
 
 /*
-*       Description: A function that trims row and columns if needed to 
-*       create even numbers of rows and columns. 
+*       Description: A function that converts the blocks inside a window of
+*       an image in format 2, 3 or 5 to pixels. In format 2 the words of 
+*       each column of the window are next to each other, and in format 3 
+*       those of each row, so each is found from its offset and converted.
+*       In format 5 the words can only be decoded in order, so the columns 
+*       up to the last one of the window are decoded, and only the window 
+*       is converted.
 *
-*       In/Out Expectations: expects to take in a valid type Pnm_ppm. Mallocs
-*       space for the trimmed new Pnm_ppm and frees memory for the old.
-*       Returns a type Pnm_ppm. Memory for this Pnm_ppm must be freed by the
-*       client. 
+*       In/Out Expectations: expects a word_reader whose file is mapped or 
+*       loaded, a window of blocks inside the image, an image as big as the
+*       window, and buffers to take the words from. Returns nothing.
 */
-Pnm_ppm make_even(Pnm_ppm image) {
-        int old_width = (image->methods)->width(image->pixels);
-        int old_height = (image->methods)->height(image->pixels);
-        
-        if ((old_height % 2) == 0 && (old_width % 2) == 0) {
-                return image;
+void region_blocks(word_reader reader, tile window, arith40_image image, 
+                   arith40_buffers buffers) {
+        unsigned columns = reader->width / BLOCK_SIZE;
+        unsigned rows = reader->height / BLOCK_SIZE;
+        unsigned width = window->end_col - window->first_col;
+        unsigned height = window->end_row - window->first_row;
+        uint32_t *words = buffer_words(buffers, width > height ? width : 
+                                                                 height);
+
+        if (reader->format == FORMAT_ROWS) {
+                for (unsigned row = 0; row < height; row++) {
+                        size_t first = (size_t)(window->first_row + row) * 
+                                       columns + window->first_col;
+                        reader_words_at(reader, first, words, width);
+                        for (unsigned col = 0; col < width; col++) {
+                                word_to_image(words[col], image, col, row);
+                        }
+                }
+                return;
+        }
+        if (reader->entropy != NULL) {
+                words = buffer_words(buffers, rows);
+                for (unsigned col = 0; col < window->end_col; col++) {
+                        reader_words(reader, words, rows);
+                        if (col >= window->first_col) {
+                                word_column_to_image(words + 
+                                        window->first_row, image, 
+                                        col - window->first_col);
+                        }
+                }
+                return;
         }
+        for (unsigned col = 0; col < width; col++) {
+                size_t first = (size_t)(window->first_col + col) * rows + 
+                               window->first_row;
+                reader_words_at(reader, first, words, height);
+                word_column_to_image(words, image, col);
+        }
+}
 
-        int new_width = (old_width / 2) * 2;
-        int new_height = (old_height / 2) * 2;
-        Pnm_ppm new_image = malloc(sizeof(struct Pnm_ppm));
-        A2Methods_UArray2 new_pixmap = image->methods->
-                        new(new_width, new_height,image->methods->
-                        size(image->pixels));
-        new_image->width = new_width;
-        new_image->height = new_height;
-        new_image->pixels = new_pixmap;
-        new_image->methods = image->methods;
-        new_image->denominator = image->denominator;
+/*
+*       Description: A function that converts the blocks inside a window of
+*       an image of a layout wider than the standard one (format 7) to 
+*       pixels. Like format 2, the words of each column of the window are 
+*       next to each other, each stored as two words of 32 bits, so each 
+*       column is found from its offset and converted.
+*
+*       In/Out Expectations: expects a word_reader whose file is mapped or 
+*       loaded, a window of blocks inside the image, an image as big as the
+*       window, and buffers to take the words from. Returns nothing.
+*/
+void region_layout(word_reader reader, tile window, arith40_image image, 
+                   arith40_buffers buffers) {
+        word_layout layout = format_to_layout(reader->format);
+        assert(layout->word_bits == 2 * HALF_BITS);
+        unsigned rows = reader->height / BLOCK_SIZE;
+        unsigned width = window->end_col - window->first_col;
+        unsigned height = window->end_row - window->first_row;
+        uint32_t *halves = buffer_words(buffers, 2 * (size_t)height);
+        uint64_t *words = buffer_wide_words(buffers, height);
+
+        for (unsigned col = 0; col < width; col++) {
+                size_t first = (size_t)(window->first_col + col) * rows + 
+                               window->first_row;
+                reader_words_at(reader, 2 * first, halves, 2 * height);
+                halves_to_wide_words(halves, height, words);
+                for (unsigned row = 0; row < height; row++) {
+                        layout_word_to_image(layout, words[row], image, col,
+                                             row);
+                }
+        }
+}
 
-        image->methods->map_block_major(new_image->pixels, copy_pixmap, image);
+/*
+*       Description: A function that converts the blocks inside a window of
+*       a tiled image (format 4) to pixels. Only the tiles that overlap the
+*       window are found in the index, checked and converted.
+*
+*       In/Out Expectations: expects a word_reader of a tiled file that is 
+*       mapped or loaded, a window of blocks inside the image, and an image 
+*       as big as the window. Asserts that the index and the tiles used are
+*       valid. Returns nothing.
+*/
+void region_tiles(word_reader reader, tile window, arith40_image image) {
+        struct tile_index index;
+        size_t index_length = bytes_to_tile_index(reader->words, 
+                reader->length, reader->width, reader->height, &index);
+        assert(index_length > 0);
+        if (window->first_col == window->end_col || 
+            window->first_row == window->end_row) {
+                return;
+        }
 
+        unsigned first_col = window->first_col / index.tile_blocks;
+        unsigned end_col = (window->end_col - 1) / index.tile_blocks + 1;
+        unsigned first_row = window->first_row / index.tile_blocks;
+        unsigned end_row = (window->end_row - 1) / index.tile_blocks + 1;
+        for (unsigned row = first_row; row < end_row; row++) {
+                for (unsigned col = first_col; col < end_col; col++) {
+                        struct tile curr_tile;
+                        bool valid = index_to_tile(&index, 
+                                row * index.tile_columns + col, &curr_tile);
+                        assert(valid);
+                        word_tile_to_image(index.data + curr_tile.offset, 
+                                           &curr_tile, image, window);
+                }
+        }
+}
+
+/*
+*       Description: A function that decompresses a thumbnail of an image, 
+*       in any format, half as wide and half as tall as the image, and 
+*       writes it as a ppm. Each word becomes one pixel, the mean of its 
+*       block, from a, pb_avg and pr_avg alone, so b, c and d are never 
+*       unpacked, the inverse DCT is never taken and no block is expanded to
+*       4 pixels. Formats 2 and 3 are read a column or a row of words at a
+*       time; a tiled file is loaded into memory and each tile checked.
+*
+*       In/Out Expectations: expects an open word_reader, an output file 
+*       open for writing, the maxval to write the thumbnail with, and 
+*       buffers to take the thumbnail and words from. Asserts that the index
+*       and the tiles of a tiled file are valid. Returns nothing.
+*/
+void decompress_thumbnail(word_reader reader, FILE *output, unsigned maxval,
+                          arith40_buffers buffers) {
+        unsigned columns = reader->width / BLOCK_SIZE;
+        unsigned rows = reader->height / BLOCK_SIZE;
+        struct arith40_image image;
+        new_image(buffers, columns, rows, maxval, &image);
+
+        if (reader->format == FORMAT_TILES) {
+                load_word_reader(reader);
+                struct tile_index index;
+                size_t index_length = bytes_to_tile_index(reader->words, 
+                        reader->length, reader->width, reader->height, 
+                        &index);
+                assert(index_length > 0);
+                size_t count = (size_t)index.tile_columns * 
+                               index.tile_rows;
+                for (size_t k = 0; k < count; k++) {
+                        struct tile curr_tile;
+                        bool valid = index_to_tile(&index, k, &curr_tile);
+                        assert(valid);
+                        word_tile_to_thumbnail(index.data + 
+                                               curr_tile.offset, 
+                                               &curr_tile, &image);
+                }
+        } else if (reader->format == FORMAT_FINE) {
+                word_layout layout = format_to_layout(reader->format);
+                uint32_t *halves = buffer_words(buffers, 2 * (size_t)rows);
+                uint64_t *words = buffer_wide_words(buffers, rows);
+                for (unsigned col = 0; col < columns; col++) {
+                        reader_words(reader, halves, 2 * rows);
+                        halves_to_wide_words(halves, rows, words);
+                        for (unsigned row = 0; row < rows; row++) {
+                                layout_word_to_thumbnail(layout, words[row],
+                                                         &image, col, row);
+                        }
+                }
+        } else {
+                bool by_rows = reader->format == FORMAT_ROWS;
+                unsigned lines = by_rows ? rows : columns;
+                unsigned length = by_rows ? columns : rows;
+                uint32_t *words = buffer_words(buffers, length);
+                for (unsigned line = 0; line < lines; line++) {
+                        reader_words(reader, words, length);
+                        for (unsigned k = 0; k < length; k++) {
+                                word_to_thumbnail(words[k], &image, 
+                                                  by_rows ? k : line, 
+                                                  by_rows ? line : k);
+                        }
+                }
+        }
+
+        write_ppm_header(output, image.width, image.height, image.maxval);
+        write_ppm_pixels(output, &image);
+}
+
+/*
+*       Description: A function that splits the tiles of an image into 
+*       ranges of tiles and converts each range on its own thread, or all of
+*       them on this thread if it is given fewer than 2 threads.
+*
+*       In/Out Expectations: expects an image, the index of its tiles, the 
+*       words of every tile (or NULL, when decompressing), the number of 
+*       threads to use, and the function each thread runs, which is given a
+*       struct tiles. Returns false if any range is not valid.
+*/
+bool run_tiles(arith40_image image, tile_index index, uint32_t *words, 
+               unsigned threads, void *(*convert)(void *)) {
+        size_t count = (size_t)index->tile_columns * index->tile_rows;
+        if (threads > count) {
+                threads = count > 0 ? count : 1;
+        }
+        if (threads < 1) {
+                threads = 1;
+        }
+
+        pthread_t workers[threads];
+        struct tiles ranges[threads];
+        for (unsigned t = 0; t < threads; t++) {
+                ranges[t].image = image;
+                ranges[t].index = index;
+                ranges[t].first_tile = (uint64_t)count * t / threads;
+                ranges[t].end_tile = (uint64_t)count * (t + 1) / threads;
+                ranges[t].words = words;
+                ranges[t].valid = true;
+        }
+        if (threads == 1) {
+                convert(&ranges[0]);
+                return ranges[0].valid;
+        }
+
+        for (unsigned t = 0; t < threads; t++) {
+                int error = pthread_create(&workers[t], NULL, convert, 
+                                           &ranges[t]);
+                assert(error == 0);
+        }
+        bool valid = true;
+        for (unsigned t = 0; t < threads; t++) {
+                pthread_join(workers[t], NULL);
+                valid = valid && ranges[t].valid;
+        }
+        return valid;
+}
+
+/*
+*       Description: The staged compression pipeline, which builds a 
+*       cv_pixmap, an unpacked_pixmap and a word_pixmap before writing. It
+*       is kept as the reference the fused compress40 is validated against.
+*
+*       In/Out Expectations: expects to take in a valid ppm type input file.
+*       Writes exactly the same bytes to standard output as compress40, then
+*       frees the temporary pixmaps all at once with the arena they are 
+*       allocated in. No return value.
+*/
+void compress40_staged(FILE *input) {
+        assert(input != NULL);
+
+        Pnm_ppm image = read_rgb_image(input);
+        Arena40_T arena = Arena40_new();
+
+        cv_pixmap cv_image = rgb_to_cv_pixmap(image, arena);
+        unpacked_pixmap unpacked_image = cv_to_unpacked_pixmap(cv_image, 
+                                                               arena);
+        word_pixmap packed_image = unpacked_to_word_pixmap(unpacked_image, 
+                                                           arena);
+        write_to_file(packed_image, stdout);
+ 
+        Arena40_dispose(&arena);
         Pnm_ppmfree(&image);
-        
-        return new_image;
-}
-
-/*
-*       Description: A function that sets all values of an new Pnm_ppm
-*       equal to all values of an old Pnm_ppm. 
-*
-*       In/Out Expectations: expects to take in element to set in the new 
-*       Pnm_ppm, the row and col value of this element, and the old Pnm_ppm.
-*       The element passed will be set with the corresponding value at the 
-*       same row and col index of the old Pnm_ppm. Returns void. Expects the
-*       element of the new Pnm_ppm to be of type Pnm_rgb, and for the old 
-*       Pnm_ppm to be a valid Pnm_ppm containing types Pnm_rgb.
-*/
-void copy_pixmap(int i, int j, A2Methods_UArray2 array2, 
-                     A2Methods_Object *rgb, void *image) {
-        Pnm_ppm old_image = (Pnm_ppm)image;
-        Pnm_rgb new_rgb =  (Pnm_rgb)rgb;
-        Pnm_rgb old_rgb = old_image->methods->
-                                   at(old_image->pixels, i, j);
-        *(new_rgb) = *(old_rgb);
-        (void)array2;
-}
\ No newline at end of file
+}
+
+/*
+*       Description: The staged decompression pipeline, which builds a 
+*       word_pixmap, an unpacked_pixmap and a cv_pixmap before the Pnm_ppm.
+*       It is kept as the reference the fused decompress40 is validated 
+*       against.
+*
+*       In/Out Expectations: expects to take in a valid input file with
+*       formatted header and characters as specified in the Arith40 spec. 
+*       Writes exactly the same bytes to standard output as decompress40, 
+*       then frees the temporary pixmaps and the Pnm_ppm all at once with 
+*       the arena they are allocated in. Returns nothing.
+*/
+void decompress40_staged(FILE *input){
+        assert(input != NULL);
+
+        Arena40_T arena = Arena40_new();
+        word_pixmap word_image = read_from_file(input, arena);
+        unpacked_pixmap unpacked_image = word_to_unpacked_pixmap(word_image,
+                                                                 arena);
+        cv_pixmap cv_image = unpacked_to_cv_pixmap(unpacked_image, arena);
+        Pnm_ppm rgb_image = cv_to_rgb_pixmap(cv_image, arena);
+        write_rgb_image(stdout, rgb_image);
+
+        Arena40_dispose(&arena);
+}
+
+/*
+*       Description: A function that reads a binary or plain ppm file into 
+*       an image whose pixels are held in the bytes of a set of buffers, laid
+*       out the way a binary ppm file holds them.
+*
+*       In/Out Expectations: expects to take in a valid binary or plain ppm
+*       type input file, buffers made by new_arith40_buffers, and the image 
+*       to set. The pixels stay owned by the buffers. Returns void.
+*/
+void read_image(FILE *input, arith40_buffers buffers, arith40_image image) {
+        unsigned width, height, denominator;
+        unsigned kind = read_ppm_header(input, &width, &height, &denominator);
+
+        size_t sample_bytes = denominator > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        image->width = width;
+        image->height = height;
+        image->maxval = denominator;
+        image->stride = (size_t)width * 3 * sample_bytes;
+        image->pixels = buffer_bytes(buffers, image->stride * height);
+        read_ppm_pixels(input, kind, image);
+}
+
+/*
+*       Description: A function that creates an empty image to decompress 
+*       into, whose pixels are held in the bytes of a set of buffers.
+*
+*       In/Out Expectations: expects buffers made by new_arith40_buffers, a
+*       width and height, the maxval of the image, and the image to 
+*       set. The pixels stay owned by the buffers. Returns void.
+*/
+void new_image(arith40_buffers buffers, unsigned width, unsigned height, 
+               unsigned maxval, arith40_image image) {
+        size_t sample_bytes = maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        image->width = width;
+        image->height = height;
+        image->maxval = maxval;
+        image->stride = (size_t)width * 3 * sample_bytes;
+        image->pixels = buffer_bytes(buffers, image->stride * height);
+}
+
+/*
+*       Description: A function that reads a Pnm_ppm from an input file, 
+*       holding the libpnm lock while it does.
+*
+*       In/Out Expectations: expects to take in a valid ppm type input file.
+*       Returns the Pnm_ppm, which must be freed by the client with
+*       Pnm_ppmfree.
+*/
+Pnm_ppm read_rgb_image(FILE *input) {
+        A2Methods_T methods = uarray2_methods_blocked;
+
+        pthread_mutex_lock(&pnm_lock);
+        Pnm_ppm image = Pnm_ppmread(input, methods);
+        pthread_mutex_unlock(&pnm_lock);
+
+        assert(image != NULL);
+        return image;
+}
+
+/*
+*       Description: A function that writes a Pnm_ppm to an output file, 
+*       holding the libpnm lock while it does.
+*
+*       In/Out Expectations: expects an output file open for writing and a
+*       valid Pnm_ppm. Returns void.
+*/
+void write_rgb_image(FILE *output, Pnm_ppm image) {
+        pthread_mutex_lock(&pnm_lock);
+        Pnm_ppmwrite(output, image);
+        pthread_mutex_unlock(&pnm_lock);
+}
+
+/*
+*       Description: A function that closes the asynchronous wrapper of a 
+*       file. The wrapper reports a read or write that failed behind it only
+*       through fclose, and such a failure has already set the error 
+*       indicator of the file, just as it is set when the file is used 
+*       without a wrapper, so the caller learns of it from ferror either 
+*       way.
+*
+*       In/Out Expectations: expects a wrapper made by open_async_input or 
+*       open_async_output and the file it wraps. It is a checked run-time 
+*       error for closing the wrapper to fail while the error indicator of 
+*       the file is clear. Returns void.
+*/
+void close_async_file(FILE *wrapper, FILE *file) {
+        if (fclose(wrapper) != 0) {
+                assert(ferror(file));
+        }
+}
+
+/*
+*       Description: A function that joins the two words of 32 bits each 
+*       word of a layout wider than the standard one is stored as, the high
+*       one first.
+*
+*       In/Out Expectations: expects 2 * count halves and an array with 
+*       room for count words. Returns void.
+*/
+void halves_to_wide_words(const uint32_t *halves, unsigned count, 
+                          uint64_t *words) {
+        for (unsigned k = 0; k < count; k++) {
+                words[k] = (uint64_t)halves[2 * k] << HALF_BITS | 
+                           halves[2 * k + 1];
+        }
+}
+
+/*
+*       Description: A function that creates an empty set of buffers, which
+*       grow as they are used.
+*
+*       In/Out Expectations: Mallocs space for the buffers, which must be 
+*       freed by the client with free_arith40_buffers. Returns the buffers.
+*/
+arith40_buffers new_arith40_buffers(void) {
+        arith40_buffers buffers = malloc(sizeof(*buffers));
+        assert(buffers != NULL);
+
+        buffers->words = NULL;
+        buffers->words_length = 0;
+        buffers->wide_words = NULL;
+        buffers->wide_words_length = 0;
+        buffers->rows = NULL;
+        buffers->rows_length = 0;
+        buffers->bytes = NULL;
+        buffers->bytes_length = 0;
+        return buffers;
+}
+
+/*
+*       Description: Frees memory associated with a set of buffers.
+*
+*       In/Out Expectations: expects a pointer to buffers made by 
+*       new_arith40_buffers. Frees them and sets the pointer to NULL. 
+*       Returns void.
+*/
+void free_arith40_buffers(arith40_buffers *buffers) {
+        assert(buffers != NULL && *buffers != NULL);
+
+        free((*buffers)->words);
+        free((*buffers)->wide_words);
+        free((*buffers)->rows);
+        free((*buffers)->bytes);
+        free(*buffers);
+        *buffers = NULL;
+}
+
+/*
+*       Description: A function that gets the word array of a set of 
+*       buffers, growing it first if it holds fewer than count words.
+*
+*       In/Out Expectations: expects buffers made by new_arith40_buffers and
+*       the number of words needed. Returns the array, which stays owned by
+*       the buffers.
+*/
+uint32_t *buffer_words(arith40_buffers buffers, size_t count) {
+        if (count > buffers->words_length || buffers->words == NULL) {
+                free(buffers->words);
+                buffers->words = malloc((count + 1) * sizeof(uint32_t));
+                assert(buffers->words != NULL);
+                buffers->words_length = count;
+        }
+        return buffers->words;
+}
+
+/*
+*       Description: A function that gets the array of 64 bit words of a set
+*       of buffers, growing it first if it holds fewer than count words.
+*
+*       In/Out Expectations: expects buffers made by new_arith40_buffers and
+*       the number of words needed. Returns the array, which stays owned by
+*       the buffers.
+*/
+uint64_t *buffer_wide_words(arith40_buffers buffers, size_t count) {
+        if (count > buffers->wide_words_length || 
+            buffers->wide_words == NULL) {
+                free(buffers->wide_words);
+                buffers->wide_words = malloc((count + 1) * sizeof(uint64_t));
+                assert(buffers->wide_words != NULL);
+                buffers->wide_words_length = count;
+        }
+        return buffers->wide_words;
+}
+
+/*
+*       Description: A function that gets the two rows of pixels of a set of
+*       buffers, growing them first if each holds fewer than width pixels.
+*
+*       In/Out Expectations: expects buffers made by new_arith40_buffers and
+*       the width of a row. Returns an array of 2 * width Pnm_rgbs, the top
+*       row followed by the bottom one, which stays owned by the buffers.
+*/
+struct Pnm_rgb *buffer_rows(arith40_buffers buffers, unsigned width) {
+        size_t length = (size_t)width * BLOCK_SIZE;
+        if (length > buffers->rows_length || buffers->rows == NULL) {
+                free(buffers->rows);
+                buffers->rows = malloc((length + 1) * sizeof(struct Pnm_rgb));
+                assert(buffers->rows != NULL);
+                buffers->rows_length = length;
+        }
+        return buffers->rows;
+}
+
+/*
+*       Description: A function that gets the bytes of a set of buffers, 
+*       growing them first if they hold fewer than length bytes.
+*
+*       In/Out Expectations: expects buffers made by new_arith40_buffers and
+*       the number of bytes needed. Returns the bytes, which stay owned by 
+*       the buffers.
+*/
+unsigned char *buffer_bytes(arith40_buffers buffers, size_t length) {
+        if (length > buffers->bytes_length || buffers->bytes == NULL) {
+                free(buffers->bytes);
+                buffers->bytes = malloc(length + 1);
+                assert(buffers->bytes != NULL);
+                buffers->bytes_length = length;
+        }
+        return buffers->bytes;
+}
@@ -1,4 +1,8 @@
+#ifndef COMPRESS40_
+#define COMPRESS40_
+
 #include <stdio.h>
+#include <stdbool.h>
 
 /*
  * The two functions below are functions you should implement.
@@ -8,3 +12,119 @@
 
 extern void compress40  (FILE *input);  /* reads PPM, writes compressed image */
 extern void decompress40(FILE *input);  /* reads compressed image, writes PPM */
+
+/*
+ * Buffers that can be reused from one image to the next, so a process that
+ * compresses or decompresses many images does not allocate them every time;
+ * one set of buffers must not be used by two images at once
+ */
+typedef struct arith40_buffers *arith40_buffers;
+
+extern arith40_buffers new_arith40_buffers(void);
+extern void free_arith40_buffers(arith40_buffers *buffers);
+
+/*
+ * A rectangle of pixels: the column and row of its top left pixel, and its
+ * width and height
+ */
+typedef struct arith40_region {
+        unsigned x, y, width, height;
+} *arith40_region;
+
+/* a layout of the words of a compressed image (see word_layout.h) */
+struct word_layout;
+
+/*
+ * struct arith40_options
+ *      How compress40_with and decompress40_with do their work. stream,
+ *      tiled, entropy, progressive and layout each choose the format to
+ *      compress to, so at most one of them is set; with none, compress40 
+ *      writes format 2. The defaults are ARITH40_DEFAULT_OPTIONS.
+ */
+typedef struct arith40_options {
+        /* threads to split one image across (0 or 1 for none) */
+        unsigned threads;
+
+        /* 
+         * compress binary (P6) ppm files two rows of pixels at a time, 
+         * writing the blocks row by row as format 3
+         */
+        bool stream;
+
+        /* 
+         * compress to format 4, tiles that can each be found and 
+         * decompressed on their own, each checked with a CRC32C
+         */
+        bool tiled;
+
+        /* compress to format 5, the fields of the words Huffman coded */
+        bool entropy;
+
+        /* 
+         * compress to format 6, the coarse fields of every word before the
+         * detail fields of any
+         */
+        bool progressive;
+
+        /* 
+         * read ahead and write behind on threads of their own, so waiting 
+         * on the files overlaps converting
+         */
+        bool async;
+
+        /* 
+         * decompress an image half as wide and half as tall, one pixel per
+         * block made from the averages in its word alone (region is then 
+         * not used)
+         */
+        bool thumbnail;
+
+        /* 
+         * the maxval of decompressed images, 0 for the default of 3000; 
+         * 255 writes one byte per sample, half the output
+         */
+        unsigned maxval;
+
+        /* 
+         * if not NULL, the only part of the image decompressed and written,
+         * clipped to the image
+         */
+        arith40_region region;
+
+        /* if not NULL, reused instead of allocating new buffers */
+        arith40_buffers buffers;
+
+        /* 
+         * if not NULL or the standard layout, compress to the words of this
+         * layout, column by column on one thread; fine_layout writes format
+         * 7, twice the size of format 2 at a higher quality, whose 
+         * regions and thumbnails are decompressed like those of format 2
+         */
+        const struct word_layout *layout;
+} *arith40_options;
+
+/*
+ * The options compress40 and decompress40 use: one thread, the standard 
+ * layout, and every other option off
+ */
+#define ARITH40_DEFAULT_OPTIONS { .threads = 1 }
+
+/*
+ * compress40 and decompress40 writing to the given file instead of stdout,
+ * done the way the options (or NULL, for the defaults) say; decompress40_with
+ * reads every format, 2 through 7, and every way of compressing an image in
+ * the same format writes the same bytes
+ */
+extern void compress40_with(FILE *input, FILE *output, 
+                            arith40_options options);
+extern void decompress40_with(FILE *input, FILE *output, 
+                              arith40_options options);
+
+/*
+ * The staged pipeline the fused functions above are validated against;
+ * it writes the same bytes as its fused counterpart
+ */
+extern void compress40_staged(FILE *input);
+extern void decompress40_staged(FILE *input);
+
+#endif
@@ -7,7 +7,13 @@
 *   
 *       This file contains the functions necessary to convert an image in the
 *       form of a Pnm_ppm to a cv_pixmap (compression), and back from
-*       a cv_pixmap to a Pnm_ppm (decompression). 
+*       a cv_pixmap to a Pnm_ppm (decompression). Runs of pixels held in 
+*       memory as samples can also be converted to, or back from, a 
+*       structure of arrays of their components, 8 pixels per instruction 
+*       with AVX2 or 4 with SSE2 when the CPU running the codec has them, 
+*       which is checked once, on first use. The vector functions do the 
+*       same float and double operations as rgb_to_cv and cv_to_rgb, in the
+*       same order, so they give exactly the same components and samples.
 *   
 ******************************************************************************/
 
@@ -15,6 +21,8 @@
 #include <math.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
 #include <a2methods.h>
 #include "assert.h"
 #include "pnm.h"
@@ -23,19 +31,59 @@
 #include "cv_rgb.h"
 
 #define BLOCK_SIZE 2
-#define CHOSEN_DENOMINATOR 3000
-
+#define SAMPLES_PER_PIXEL 3
+#define ONE_BYTE_DENOMINATOR 255
+#define CHAR_BITS 8
+
+/* the x86 vector instructions the run functions can use */
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CV_SIMD 1
+#else
+#define CV_SIMD 0
+#endif
+
+/* 
+ * the run functions for the CPU running the codec, chosen by 
+ * choose_cv_functions the first time one of them is called
+ */
+static void (*rgb_run_to_cv)(cv_planes planes, unsigned count, 
+                             unsigned denominator);
+static void (*cv_run_to_rgb)(cv_planes planes, unsigned count, 
+                             unsigned denominator);
+static pthread_once_t cv_functions_once = PTHREAD_ONCE_INIT;
+
+/******** HELPER FUNCTIONS ********/
+void choose_cv_functions(void);
 
 /******** COMPRESSION HELPER FUNCTIONS ********/
-void rgb_to_cv(Pnm_rgb rgb, int denominator, cv_t cv);
 void rgb_to_cv_mapping(int i, int j, A2Methods_UArray2 array2, 
                 A2Methods_Object *cv, void *ppm);
+void rgb_run_to_cv_scalar(cv_planes planes, unsigned first, 
+                          unsigned count, unsigned denominator);
+void rgb_run_to_cv_portable(cv_planes planes, unsigned count, 
+                            unsigned denominator);
+#if CV_SIMD
+void rgb_run_to_cv_sse2(cv_planes planes, unsigned count, 
+                        unsigned denominator);
+void rgb_run_to_cv_avx2(cv_planes planes, unsigned count, 
+                        unsigned denominator);
+#endif
 
 /******** DECOMPRESSION HELPER FUNCTIONS ********/
 void cv_to_rgb_mapping(int i, int j, A2Methods_UArray2 array2, 
                 A2Methods_Object *rgb, void *pixmap);
-void cv_to_rgb(cv_t cv, Pnm_rgb rgb);
-unsigned rgb_unsigned(float color); 
+unsigned rgb_unsigned(float color, unsigned denominator);
+void cv_run_to_rgb_scalar(cv_planes planes, unsigned first, 
+                          unsigned count, unsigned denominator);
+void cv_run_to_rgb_portable(cv_planes planes, unsigned count, 
+                            unsigned denominator);
+#if CV_SIMD
+void cv_run_to_rgb_sse2(cv_planes planes, unsigned count, 
+                        unsigned denominator);
+void cv_run_to_rgb_avx2(cv_planes planes, unsigned count, 
+                        unsigned denominator);
+#endif
 
 
 
@@ -44,30 +92,30 @@ unsigned rgb_unsigned(float color);
 /*
 *       Description: A function that takes Pnm_oom containing
 *       a 2D array of types Pnm_rgb and creates an associated struct
-*       cv_pixmap containing a 2D array of cv_ts. 
+*       cv_pixmap containing a 2D array of cv_ts. A last odd row or
+*       column of the Pnm_ppm is left out of the cv_pixmap.
 *
 *   
-*       In/Out Expectations: Expects a valid struct type Pnm_ppm. Mallocs
-*       memory for a struct cv_pixmap that the client must eventually free.
-*       Returns this created type of cv_pixmap.  
+*       In/Out Expectations: Expects a valid struct type Pnm_ppm and an 
+*       arena. Allocates the struct cv_pixmap in the arena, which frees it
+*       when it is reset. Returns this created type of cv_pixmap.  
 */
-cv_pixmap rgb_to_cv_pixmap(Pnm_ppm ppm) {
+cv_pixmap rgb_to_cv_pixmap(Pnm_ppm ppm, Arena40_T arena) {
         assert(ppm != NULL);
 
-        int width = ppm->width;
-        int height = ppm->height;
+        int width = (ppm->width / BLOCK_SIZE) * BLOCK_SIZE;
+        int height = (ppm->height / BLOCK_SIZE) * BLOCK_SIZE;
 
-        cv_pixmap new_cv_pixmap = malloc(sizeof(*new_cv_pixmap));
-        assert(new_cv_pixmap != NULL);
+        cv_pixmap new_cv_pixmap = Arena40_alloc(arena, 
+                                                sizeof(*new_cv_pixmap));
 
         new_cv_pixmap->width = width;
         new_cv_pixmap->height = height;
         new_cv_pixmap->methods = uarray2_methods_blocked;
         
         cv_t dummy_cv;
-        A2Methods_UArray2 pixmap = new_cv_pixmap->
-                methods->new_with_blocksize(width, height, sizeof(*dummy_cv),
-                BLOCK_SIZE);
+        A2Methods_UArray2 pixmap = UArray2b_new_in(arena, width, height, 
+                sizeof(*dummy_cv), BLOCK_SIZE);
         new_cv_pixmap->pixels = pixmap;
 
         new_cv_pixmap->methods->map_block_major(new_cv_pixmap->pixels,
@@ -122,6 +170,208 @@ void rgb_to_cv(Pnm_rgb rgb, int denominator, cv_t cv) {
         cv->pr = pr;
 }
 
+/*
+*       Description: Converts the pixels of a rectangle of samples held in 
+*       memory to component video, row by row, left to right inside each 
+*       row. The samples are copied into the planes, then converted there 
+*       with the widest vector instructions the CPU has. The components are
+*       the ones rgb_to_cv gives.
+*
+*       In/Out Expectations: expects the samples of the top left pixel of 
+*       the rectangle, each one byte if the denominator is at most 255 and 
+*       otherwise two bytes, most significant first, the number of bytes 
+*       from one row of samples to the next, the width and height of the 
+*       rectangle, in pixels, its denominator, and a cv_planes whose arrays
+*       each have room for width * height components, which are set. 
+*       Returns void.
+*/
+void samples_to_cv(const unsigned char *samples, size_t stride, 
+                   unsigned width, unsigned height, unsigned denominator, 
+                   cv_planes planes) {
+        assert(samples != NULL);
+        assert(planes != NULL);
+
+        unsigned k = 0;
+        for (unsigned row = 0; row < height; row++) {
+                const unsigned char *bytes = samples + (size_t)row * stride;
+                if (denominator <= ONE_BYTE_DENOMINATOR) {
+                        for (unsigned col = 0; col < width; col++, k++) {
+                                planes->y[k] = bytes[0];
+                                planes->pb[k] = bytes[1];
+                                planes->pr[k] = bytes[2];
+                                bytes += SAMPLES_PER_PIXEL;
+                        }
+                } else {
+                        for (unsigned col = 0; col < width; col++, k++) {
+                                planes->y[k] = bytes[0] << CHAR_BITS | 
+                                               bytes[1];
+                                planes->pb[k] = bytes[2] << CHAR_BITS | 
+                                                bytes[3];
+                                planes->pr[k] = bytes[4] << CHAR_BITS | 
+                                                bytes[5];
+                                bytes += 2 * SAMPLES_PER_PIXEL;
+                        }
+                }
+        }
+
+        pthread_once(&cv_functions_once, choose_cv_functions);
+        rgb_run_to_cv(planes, k, denominator);
+}
+
+/*
+*       Description: Converts the pixels [first, count) of a run from red, 
+*       green and blue to component video one at a time with rgb_to_cv: the
+*       whole run on a CPU without vector instructions, or the pixels left 
+*       over after the last full vector.
+*
+*       In/Out Expectations: expects a cv_planes whose y, pb and pr arrays 
+*       hold the red, green and blue samples of count pixels, the first 
+*       pixel to convert, and their denominator. Replaces the samples with
+*       the components. Returns void.
+*/
+void rgb_run_to_cv_scalar(cv_planes planes, unsigned first, 
+                          unsigned count, unsigned denominator) {
+        struct Pnm_rgb rgb;
+        struct cv_t cv;
+        for (unsigned k = first; k < count; k++) {
+                rgb.red = planes->y[k];
+                rgb.green = planes->pb[k];
+                rgb.blue = planes->pr[k];
+                rgb_to_cv(&rgb, denominator, &cv);
+                planes->y[k] = cv.y;
+                planes->pb[k] = cv.pb;
+                planes->pr[k] = cv.pr;
+        }
+}
+
+/*
+*       Description: Converts a run of pixels from red, green and blue to 
+*       component video one at a time, for a CPU without vector 
+*       instructions.
+*
+*       In/Out Expectations: like rgb_run_to_cv_scalar, from the first 
+*       pixel. Returns void.
+*/
+void rgb_run_to_cv_portable(cv_planes planes, unsigned count, 
+                            unsigned denominator) {
+        rgb_run_to_cv_scalar(planes, 0, count, denominator);
+}
+
+#if CV_SIMD
+/*
+*       Description: Converts a run of pixels from red, green and blue to 
+*       component video 4 at a time with SSE2: each sample is divided by 
+*       the denominator as a float, then the components are taken as 
+*       doubles, 2 to a register, and rounded back to floats, the way 
+*       rgb_to_cv does. The pixels left over are converted one at a time.
+*
+*       In/Out Expectations: like rgb_run_to_cv_portable, on a CPU with 
+*       SSE2. Returns void.
+*/
+__attribute__((target("sse2")))
+void rgb_run_to_cv_sse2(cv_planes planes, unsigned count, 
+                        unsigned denominator) {
+        const __m128 scale = _mm_set1_ps((float)denominator);
+        unsigned k = 0;
+        for (; k + 4 <= count; k += 4) {
+                __m128 red = _mm_div_ps(_mm_loadu_ps(planes->y + k), scale);
+                __m128 green = _mm_div_ps(_mm_loadu_ps(planes->pb + k), 
+                                          scale);
+                __m128 blue = _mm_div_ps(_mm_loadu_ps(planes->pr + k), scale);
+                __m128d r[2] = { _mm_cvtps_pd(red), 
+                                 _mm_cvtps_pd(_mm_movehl_ps(red, red)) };
+                __m128d g[2] = { _mm_cvtps_pd(green), 
+                                 _mm_cvtps_pd(_mm_movehl_ps(green, green)) };
+                __m128d b[2] = { _mm_cvtps_pd(blue), 
+                                 _mm_cvtps_pd(_mm_movehl_ps(blue, blue)) };
+                __m128 halves[SAMPLES_PER_PIXEL][2];
+                for (int h = 0; h < 2; h++) {
+                        halves[0][h] = _mm_cvtpd_ps(_mm_add_pd(_mm_add_pd(
+                                _mm_mul_pd(_mm_set1_pd(0.299), r[h]),
+                                _mm_mul_pd(_mm_set1_pd(0.587), g[h])),
+                                _mm_mul_pd(_mm_set1_pd(0.114), b[h])));
+                        halves[1][h] = _mm_cvtpd_ps(_mm_add_pd(_mm_sub_pd(
+                                _mm_mul_pd(_mm_set1_pd(-0.168736), r[h]),
+                                _mm_mul_pd(_mm_set1_pd(0.331264), g[h])),
+                                _mm_mul_pd(_mm_set1_pd(0.5), b[h])));
+                        halves[2][h] = _mm_cvtpd_ps(_mm_sub_pd(_mm_sub_pd(
+                                _mm_mul_pd(_mm_set1_pd(0.5), r[h]),
+                                _mm_mul_pd(_mm_set1_pd(0.418688), g[h])),
+                                _mm_mul_pd(_mm_set1_pd(0.081312), b[h])));
+                }
+                _mm_storeu_ps(planes->y + k, _mm_movelh_ps(halves[0][0], 
+                                                           halves[0][1]));
+                _mm_storeu_ps(planes->pb + k, _mm_movelh_ps(halves[1][0], 
+                                                            halves[1][1]));
+                _mm_storeu_ps(planes->pr + k, _mm_movelh_ps(halves[2][0], 
+                                                            halves[2][1]));
+        }
+        rgb_run_to_cv_scalar(planes, k, count, denominator);
+}
+
+/*
+*       Description: Converts a run of pixels from red, green and blue to 
+*       component video 8 at a time with AVX2, the way rgb_run_to_cv_sse2 
+*       converts 4, the doubles 4 to a register.
+*
+*       In/Out Expectations: like rgb_run_to_cv_portable, on a CPU with 
+*       AVX2. Returns void.
+*/
+__attribute__((target("avx2")))
+void rgb_run_to_cv_avx2(cv_planes planes, unsigned count, 
+                        unsigned denominator) {
+        const __m256 scale = _mm256_set1_ps((float)denominator);
+        unsigned k = 0;
+        for (; k + 8 <= count; k += 8) {
+                __m256 red = _mm256_div_ps(_mm256_loadu_ps(planes->y + k), 
+                                           scale);
+                __m256 green = _mm256_div_ps(_mm256_loadu_ps(planes->pb + k),
+                                             scale);
+                __m256 blue = _mm256_div_ps(_mm256_loadu_ps(planes->pr + k), 
+                                            scale);
+                __m256d r[2] = { 
+                        _mm256_cvtps_pd(_mm256_castps256_ps128(red)),
+                        _mm256_cvtps_pd(_mm256_extractf128_ps(red, 1)) };
+                __m256d g[2] = { 
+                        _mm256_cvtps_pd(_mm256_castps256_ps128(green)),
+                        _mm256_cvtps_pd(_mm256_extractf128_ps(green, 1)) };
+                __m256d b[2] = { 
+                        _mm256_cvtps_pd(_mm256_castps256_ps128(blue)),
+                        _mm256_cvtps_pd(_mm256_extractf128_ps(blue, 1)) };
+                __m128 halves[SAMPLES_PER_PIXEL][2];
+                for (int h = 0; h < 2; h++) {
+                        halves[0][h] = _mm256_cvtpd_ps(_mm256_add_pd(
+                                _mm256_add_pd(
+                                _mm256_mul_pd(_mm256_set1_pd(0.299), r[h]),
+                                _mm256_mul_pd(_mm256_set1_pd(0.587), g[h])),
+                                _mm256_mul_pd(_mm256_set1_pd(0.114), b[h])));
+                        halves[1][h] = _mm256_cvtpd_ps(_mm256_add_pd(
+                                _mm256_sub_pd(
+                                _mm256_mul_pd(_mm256_set1_pd(-0.168736), 
+                                              r[h]),
+                                _mm256_mul_pd(_mm256_set1_pd(0.331264), 
+                                              g[h])),
+                                _mm256_mul_pd(_mm256_set1_pd(0.5), b[h])));
+                        halves[2][h] = _mm256_cvtpd_ps(_mm256_sub_pd(
+                                _mm256_sub_pd(
+                                _mm256_mul_pd(_mm256_set1_pd(0.5), r[h]),
+                                _mm256_mul_pd(_mm256_set1_pd(0.418688), 
+                                              g[h])),
+                                _mm256_mul_pd(_mm256_set1_pd(0.081312), 
+                                              b[h])));
+                }
+                for (int c = 0; c < SAMPLES_PER_PIXEL; c++) {
+                        float *plane = c == 0 ? planes->y : 
+                                       c == 1 ? planes->pb : planes->pr;
+                        _mm256_storeu_ps(plane + k, _mm256_insertf128_ps(
+                                _mm256_castps128_ps256(halves[c][0]), 
+                                halves[c][1], 1));
+                }
+        }
+        rgb_run_to_cv_scalar(planes, k, count, denominator);
+}
+#endif
+
 
 /************ DECOMPRESSION ************/
 
@@ -130,18 +380,19 @@ void rgb_to_cv(Pnm_rgb rgb, int denominator, cv_t cv) {
 *       a 2D array of cv_ts and creates an associated Pnm_ppm containing 
 *       a 2D array of types Pnm_rgb. 
 *
-*       In/Out Expectations: Expects a struct type cv_pixmap. Mallocs
-*       memory for a Pnm_ppm that the client must eventually 
-*       free. Returns this created Pnm_ppm.  
+*       In/Out Expectations: Expects a struct type cv_pixmap and an arena.
+*       Allocates the Pnm_ppm in the arena, which frees it when it is 
+*       reset, so it must not be freed with Pnm_ppmfree. Returns this 
+*       created Pnm_ppm.  
 */
-Pnm_ppm cv_to_rgb_pixmap(cv_pixmap old_cv_pixmap) {
+Pnm_ppm cv_to_rgb_pixmap(cv_pixmap old_cv_pixmap, Arena40_T arena) {
         assert(old_cv_pixmap != NULL);
 
         int width = old_cv_pixmap->width;
         int height = old_cv_pixmap->height;
 
-        Pnm_ppm new_rgb_pixmap = malloc(sizeof(*new_rgb_pixmap));
-        assert(new_rgb_pixmap != NULL);
+        Pnm_ppm new_rgb_pixmap = Arena40_alloc(arena, 
+                                               sizeof(*new_rgb_pixmap));
 
         new_rgb_pixmap->width = width;
         new_rgb_pixmap->height = height;
@@ -149,9 +400,8 @@ Pnm_ppm cv_to_rgb_pixmap(cv_pixmap old_cv_pixmap) {
         new_rgb_pixmap->methods = uarray2_methods_blocked;
 
         Pnm_rgb dummy_rgb;
-        A2Methods_UArray2 rgb_pixmap = new_rgb_pixmap->methods->
-                new_with_blocksize(width, height, sizeof(*dummy_rgb), 
-                BLOCK_SIZE);
+        A2Methods_UArray2 rgb_pixmap = UArray2b_new_in(arena, width, height,
+                sizeof(*dummy_rgb), BLOCK_SIZE);
         new_rgb_pixmap->pixels = rgb_pixmap;
         
         
@@ -180,7 +430,7 @@ void cv_to_rgb_mapping(int i, int j, A2Methods_UArray2 array2,
         cv_t curr_cv = pixmap_cv->methods->at(pixmap_cv->pixels, i, j);
         Pnm_rgb curr_rgb = (Pnm_rgb)rgb;
 
-        cv_to_rgb(curr_cv, curr_rgb);
+        cv_to_rgb(curr_cv, CHOSEN_DENOMINATOR, curr_rgb);
 
         (void)array2;
 }
@@ -188,11 +438,11 @@ void cv_to_rgb_mapping(int i, int j, A2Methods_UArray2 array2,
 /*
 *       Description: Generates a type Pnm_rgb from a type cv_t.
 *
-*       In/Out Expectations: expects to take instace of cv_t, and an
-*       Pnm_rgb. Sets values of the Pnm_rgb with calculations using 
-*       the cv_t. Returns void.
+*       In/Out Expectations: expects to take instace of cv_t, the 
+*       denominator to scale the Pnm_rgb to, and an Pnm_rgb. Sets values of
+*       the Pnm_rgb with calculations using the cv_t. Returns void.
 */
-void cv_to_rgb(cv_t cv, Pnm_rgb rgb) {
+void cv_to_rgb(cv_t cv, unsigned denominator, Pnm_rgb rgb) {
         assert(cv != NULL);
         assert(rgb != NULL);
 
@@ -205,37 +455,265 @@ void cv_to_rgb(cv_t cv, Pnm_rgb rgb) {
         float green_scaled = (1.0 * y - 0.344136 * pb - 0.714136 * pr);
         float blue_scaled = (1.0 * y + 1.772 * pb + 0.0 * pr);
 
-        rgb->red= rgb_unsigned(red_scaled);
-        rgb->green = rgb_unsigned(green_scaled);
-        rgb->blue = rgb_unsigned(blue_scaled);
+        rgb->red= rgb_unsigned(red_scaled, denominator);
+        rgb->green = rgb_unsigned(green_scaled, denominator);
+        rgb->blue = rgb_unsigned(blue_scaled, denominator);
 }
 
 /*
 *       Description: Scales a float to a larger unsigned with a 
 *       denominator value. 
 *
-*       In/Out Expectations: expects to take in a float (any value). Returns
-*       an unsinged value between 0 and the defined denominator.
+*       In/Out Expectations: expects to take in a float (any value) and the
+*       denominator. Multiplies only once, so quantizing straight to a small
+*       denominator (like 255) is no dearer than to CHOSEN_DENOMINATOR and
+*       needs no rescaling after. Returns an unsinged value between 0 and 
+*       the denominator.
 */
-unsigned rgb_unsigned(float color){
+unsigned rgb_unsigned(float color, unsigned denominator){
+        float scaled = color * denominator;
         if (color <= 0){
                 return (unsigned) 0;
-        } else if ((color * CHOSEN_DENOMINATOR) >= CHOSEN_DENOMINATOR) {
-                return (unsigned) CHOSEN_DENOMINATOR;
+        } else if (scaled >= denominator) {
+                return denominator;
         } else {
-                return (unsigned)(color * CHOSEN_DENOMINATOR);
+                return (unsigned)scaled;
         }
 }
 
 /*
-*       Description: Frees memory associated with a cv_pixmap.
+*       Description: Converts a run of pixels in component video back to 
+*       the samples of a rectangle held in memory, row by row, left to 
+*       right inside each row. The pixels are converted in the planes with 
+*       the widest vector instructions the CPU has, then copied out as 
+*       samples. The samples are the ones cv_to_rgb gives.
 *
-*       In/Out Expectations: expects to take a cv_pixmap that's been
-*       mallocked on the heap. Frees memory for the pointer and for 
-*       each element in the 2D array of pixels. Returns void.
+*       In/Out Expectations: expects a cv_planes holding width * height 
+*       pixels, the width and height of the rectangle, in pixels, the 
+*       denominator to scale the samples to, the samples of the top left 
+*       pixel of the rectangle, each one byte if the denominator is at most
+*       255 and otherwise two bytes, most significant first, and the number
+*       of bytes from one row of samples to the next. The planes are used 
+*       to convert the pixels in, and hold the red, green and blue samples 
+*       after. Returns void.
 */
-void free_cv_pixmap(cv_pixmap pixmap) {
-        assert(pixmap != NULL);
-        pixmap->methods->free(&(pixmap->pixels));
-        free(pixmap);
-}
\ No newline at end of file
+void cv_to_samples(cv_planes planes, unsigned width, unsigned height, 
+                   unsigned denominator, unsigned char *samples, 
+                   size_t stride) {
+        assert(planes != NULL);
+        assert(samples != NULL);
+
+        pthread_once(&cv_functions_once, choose_cv_functions);
+        cv_run_to_rgb(planes, width * height, denominator);
+
+        unsigned k = 0;
+        for (unsigned row = 0; row < height; row++) {
+                unsigned char *bytes = samples + (size_t)row * stride;
+                if (denominator <= ONE_BYTE_DENOMINATOR) {
+                        for (unsigned col = 0; col < width; col++, k++) {
+                                bytes[0] = (unsigned)planes->y[k];
+                                bytes[1] = (unsigned)planes->pb[k];
+                                bytes[2] = (unsigned)planes->pr[k];
+                                bytes += SAMPLES_PER_PIXEL;
+                        }
+                        continue;
+                }
+                for (unsigned col = 0; col < width; col++, k++) {
+                        unsigned red = planes->y[k];
+                        unsigned green = planes->pb[k];
+                        unsigned blue = planes->pr[k];
+                        bytes[0] = red >> CHAR_BITS;
+                        bytes[1] = red;
+                        bytes[2] = green >> CHAR_BITS;
+                        bytes[3] = green;
+                        bytes[4] = blue >> CHAR_BITS;
+                        bytes[5] = blue;
+                        bytes += 2 * SAMPLES_PER_PIXEL;
+                }
+        }
+}
+
+/*
+*       Description: Converts the pixels [first, count) of a run from 
+*       component video to red, green and blue one at a time with 
+*       cv_to_rgb: the whole run on a CPU without vector instructions, or 
+*       the pixels left over after the last full vector.
+*
+*       In/Out Expectations: expects a cv_planes holding count pixels, the
+*       first pixel to convert, and the denominator to scale the samples 
+*       to. Replaces the components of each pixel with its red, green and 
+*       blue samples, in the y, pb and pr arrays. Returns void.
+*/
+void cv_run_to_rgb_scalar(cv_planes planes, unsigned first, 
+                          unsigned count, unsigned denominator) {
+        struct cv_t cv;
+        struct Pnm_rgb rgb;
+        for (unsigned k = first; k < count; k++) {
+                cv.y = planes->y[k];
+                cv.pb = planes->pb[k];
+                cv.pr = planes->pr[k];
+                cv_to_rgb(&cv, denominator, &rgb);
+                planes->y[k] = rgb.red;
+                planes->pb[k] = rgb.green;
+                planes->pr[k] = rgb.blue;
+        }
+}
+
+/*
+*       Description: Converts a run of pixels from component video to red,
+*       green and blue one at a time, for a CPU without vector 
+*       instructions.
+*
+*       In/Out Expectations: like cv_run_to_rgb_scalar, from the first 
+*       pixel. Returns void.
+*/
+void cv_run_to_rgb_portable(cv_planes planes, unsigned count, 
+                            unsigned denominator) {
+        cv_run_to_rgb_scalar(planes, 0, count, denominator);
+}
+
+#if CV_SIMD
+/*
+*       Description: Converts a run of pixels from component video to red,
+*       green and blue 4 at a time with SSE2: the colors are taken as 
+*       doubles, 2 to a register, and rounded back to floats, the way 
+*       cv_to_rgb does, then scaled and clamped the way rgb_unsigned does.
+*       The terms cv_to_rgb multiplies by 0.0 are left out; they can only 
+*       change the sign of a color of 0, which clamps to 0 either way. The
+*       pixels left over are converted one at a time.
+*
+*       In/Out Expectations: like cv_run_to_rgb_portable, on a CPU with 
+*       SSE2. Returns void.
+*/
+__attribute__((target("sse2")))
+void cv_run_to_rgb_sse2(cv_planes planes, unsigned count, 
+                        unsigned denominator) {
+        const __m128 scale = _mm_set1_ps((float)denominator);
+        unsigned k = 0;
+        for (; k + 4 <= count; k += 4) {
+                __m128 y = _mm_loadu_ps(planes->y + k);
+                __m128 pb = _mm_loadu_ps(planes->pb + k);
+                __m128 pr = _mm_loadu_ps(planes->pr + k);
+                __m128d ys[2] = { _mm_cvtps_pd(y), 
+                                  _mm_cvtps_pd(_mm_movehl_ps(y, y)) };
+                __m128d pbs[2] = { _mm_cvtps_pd(pb), 
+                                   _mm_cvtps_pd(_mm_movehl_ps(pb, pb)) };
+                __m128d prs[2] = { _mm_cvtps_pd(pr), 
+                                   _mm_cvtps_pd(_mm_movehl_ps(pr, pr)) };
+                __m128 halves[SAMPLES_PER_PIXEL][2];
+                for (int h = 0; h < 2; h++) {
+                        halves[0][h] = _mm_cvtpd_ps(_mm_add_pd(ys[h], 
+                                _mm_mul_pd(_mm_set1_pd(1.402), prs[h])));
+                        halves[1][h] = _mm_cvtpd_ps(_mm_sub_pd(_mm_sub_pd(
+                                ys[h], 
+                                _mm_mul_pd(_mm_set1_pd(0.344136), pbs[h])),
+                                _mm_mul_pd(_mm_set1_pd(0.714136), prs[h])));
+                        halves[2][h] = _mm_cvtpd_ps(_mm_add_pd(ys[h], 
+                                _mm_mul_pd(_mm_set1_pd(1.772), pbs[h])));
+                }
+                for (int c = 0; c < SAMPLES_PER_PIXEL; c++) {
+                        float *plane = c == 0 ? planes->y : 
+                                       c == 1 ? planes->pb : planes->pr;
+                        __m128 color = _mm_movelh_ps(halves[c][0], 
+                                                     halves[c][1]);
+                        __m128 scaled = _mm_mul_ps(color, scale);
+                        __m128 whole = _mm_cvtepi32_ps(
+                                _mm_cvttps_epi32(scaled));
+                        __m128 over = _mm_cmpge_ps(scaled, scale);
+                        whole = _mm_or_ps(_mm_and_ps(over, scale), 
+                                          _mm_andnot_ps(over, whole));
+                        whole = _mm_and_ps(_mm_cmpgt_ps(color, 
+                                                        _mm_setzero_ps()),
+                                           whole);
+                        _mm_storeu_ps(plane + k, whole);
+                }
+        }
+        cv_run_to_rgb_scalar(planes, k, count, denominator);
+}
+
+/*
+*       Description: Converts a run of pixels from component video to red,
+*       green and blue 8 at a time with AVX2, the way cv_run_to_rgb_sse2 
+*       converts 4, the doubles 4 to a register.
+*
+*       In/Out Expectations: like cv_run_to_rgb_portable, on a CPU with 
+*       AVX2. Returns void.
+*/
+__attribute__((target("avx2")))
+void cv_run_to_rgb_avx2(cv_planes planes, unsigned count, 
+                        unsigned denominator) {
+        const __m256 scale = _mm256_set1_ps((float)denominator);
+        unsigned k = 0;
+        for (; k + 8 <= count; k += 8) {
+                __m256 y = _mm256_loadu_ps(planes->y + k);
+                __m256 pb = _mm256_loadu_ps(planes->pb + k);
+                __m256 pr = _mm256_loadu_ps(planes->pr + k);
+                __m256d ys[2] = { 
+                        _mm256_cvtps_pd(_mm256_castps256_ps128(y)),
+                        _mm256_cvtps_pd(_mm256_extractf128_ps(y, 1)) };
+                __m256d pbs[2] = { 
+                        _mm256_cvtps_pd(_mm256_castps256_ps128(pb)),
+                        _mm256_cvtps_pd(_mm256_extractf128_ps(pb, 1)) };
+                __m256d prs[2] = { 
+                        _mm256_cvtps_pd(_mm256_castps256_ps128(pr)),
+                        _mm256_cvtps_pd(_mm256_extractf128_ps(pr, 1)) };
+                __m128 halves[SAMPLES_PER_PIXEL][2];
+                for (int h = 0; h < 2; h++) {
+                        halves[0][h] = _mm256_cvtpd_ps(_mm256_add_pd(ys[h],
+                                _mm256_mul_pd(_mm256_set1_pd(1.402), 
+                                              prs[h])));
+                        halves[1][h] = _mm256_cvtpd_ps(_mm256_sub_pd(
+                                _mm256_sub_pd(ys[h], 
+                                _mm256_mul_pd(_mm256_set1_pd(0.344136), 
+                                              pbs[h])),
+                                _mm256_mul_pd(_mm256_set1_pd(0.714136), 
+                                              prs[h])));
+                        halves[2][h] = _mm256_cvtpd_ps(_mm256_add_pd(ys[h],
+                                _mm256_mul_pd(_mm256_set1_pd(1.772), 
+                                              pbs[h])));
+                }
+                for (int c = 0; c < SAMPLES_PER_PIXEL; c++) {
+                        float *plane = c == 0 ? planes->y : 
+                                       c == 1 ? planes->pb : planes->pr;
+                        __m256 color = _mm256_insertf128_ps(
+                                _mm256_castps128_ps256(halves[c][0]), 
+                                halves[c][1], 1);
+                        __m256 scaled = _mm256_mul_ps(color, scale);
+                        __m256 whole = _mm256_cvtepi32_ps(
+                                _mm256_cvttps_epi32(scaled));
+                        whole = _mm256_blendv_ps(whole, scale, 
+                                _mm256_cmp_ps(scaled, scale, _CMP_GE_OQ));
+                        whole = _mm256_and_ps(_mm256_cmp_ps(color, 
+                                        _mm256_setzero_ps(), _CMP_GT_OQ), 
+                                              whole);
+                        _mm256_storeu_ps(plane + k, whole);
+                }
+        }
+        cv_run_to_rgb_scalar(planes, k, count, denominator);
+}
+#endif
+
+/*
+*       Description: Chooses the run functions for the CPU running the 
+*       codec: AVX2 if it has it, otherwise SSE2 if it has it, otherwise 
+*       the portable ones.
+*
+*       In/Out Expectations: Run once, by pthread_once. Returns void.
+*/
+void choose_cv_functions(void) {
+#if CV_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+                rgb_run_to_cv = rgb_run_to_cv_avx2;
+                cv_run_to_rgb = cv_run_to_rgb_avx2;
+                return;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+                rgb_run_to_cv = rgb_run_to_cv_sse2;
+                cv_run_to_rgb = cv_run_to_rgb_sse2;
+                return;
+        }
+#endif
+        rgb_run_to_cv = rgb_run_to_cv_portable;
+        cv_run_to_rgb = cv_run_to_rgb_portable;
+}
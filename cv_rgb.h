@@ -16,10 +16,15 @@
 #ifndef CV_RBG_
 #define CV_RBG_
 
+#include <stddef.h>
 #include <a2methods.h>
 #include "pnm.h"
+#include "arena40.h"
 #include "cv_rgb.h"
 
+/* the denominator of every decompressed image */
+#define CHOSEN_DENOMINATOR 3000
+
 /* 
  * struct cv_t
  *      A struct that represents a pixel in component video color. Contains 3 
@@ -29,6 +34,17 @@ typedef struct cv_t {
     float y, pb, pr;
 } *cv_t;
 
+/* 
+ * struct cv_planes
+ *      A struct that holds a run of pixels in component video color as a 
+ *      structure of arrays, one array per component, the k-th element of 
+ *      each array being the component of the k-th pixel, so the pixels of 
+ *      a run can be converted at once with vector instructions.
+ */
+typedef struct cv_planes {
+        float *y, *pb, *pr;
+} *cv_planes;
+
 /* 
  * struct cv_pixmap
  *      A struct that represents an entire pixmap in component video color. 
@@ -43,12 +59,18 @@ typedef struct cv_pixmap {
 } *cv_pixmap;
 
 /********** COMPRESSION **********/
-cv_pixmap rgb_to_cv_pixmap(Pnm_ppm ppm);
+cv_pixmap rgb_to_cv_pixmap(Pnm_ppm ppm, Arena40_T arena);
+void rgb_to_cv(Pnm_rgb rgb, int denominator, cv_t cv);
+void samples_to_cv(const unsigned char *samples, size_t stride, 
+                   unsigned width, unsigned height, unsigned denominator, 
+                   cv_planes planes);
 
 /********** DECOMPRESSION **********/
-Pnm_ppm cv_to_rgb_pixmap(cv_pixmap old_cv_pixmap);
-
-void free_cv_pixmap(cv_pixmap pixmap);
+Pnm_ppm cv_to_rgb_pixmap(cv_pixmap old_cv_pixmap, Arena40_T arena);
+void cv_to_rgb(cv_t cv, unsigned denominator, Pnm_rgb rgb);
+void cv_to_samples(cv_planes planes, unsigned width, unsigned height, 
+                   unsigned denominator, unsigned char *samples, 
+                   size_t stride);
 
 #endif
 
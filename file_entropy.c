@@ -0,0 +1,657 @@
+/******************************************************************************
+*       file_entropy.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains the functions necessary to write the words of an
+*       image with a Huffman code for each field (compression), and to read
+*       them back from bytes held in memory (decompression). The codes of a
+*       field are limited to a length of the field, at most MAX_CODE_BITS
+*       bits, so each one is decoded with a single lookup in a table of the
+*       field, and the tables together are small enough to stay in the L1
+*       cache. Each lookup needs the bits the one before left, so the words
+*       are dealt to ENTROPY_STREAMS streams, whose lookups do not wait on
+*       each other. The streams are written and read with the bit_writer and
+*       bit_reader of bitstream.h.
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "assert.h"
+#include "bitstream.h"
+#include "file_entropy.h"
+
+#define CHAR_BITS 8
+#define LENGTH_BITS 4
+
+/* 
+ * the fields decoded between refills: 3 * MAX_CODE_BITS bits at most, no
+ * more than STREAM_REFILL_BITS
+ */
+#define FIELDS_PER_REFILL 3
+
+/* the top bit of a field of a word, and all of its bits */
+#define FIELD_TOP(width, lsb) (1u << ((lsb) + (width) - 1))
+#define FIELD_MASK(width, lsb) ((uint32_t)(((1ull << (width)) - 1) << (lsb)))
+
+/*
+ * the bits of the fields coded as differences (a, pb_avg and pr_avg): the
+ * top bit of each, and the rest of their bits
+ */
+#define PREDICTED_HIGH (FIELD_TOP(STANDARD_WIDTH_A, STANDARD_LSB_A) |     \
+                        FIELD_TOP(STANDARD_WIDTH_PB, STANDARD_LSB_PB) |   \
+                        FIELD_TOP(STANDARD_WIDTH_PR, STANDARD_LSB_PR))
+#define PREDICTED_LOW ((FIELD_MASK(STANDARD_WIDTH_A, STANDARD_LSB_A) |    \
+                        FIELD_MASK(STANDARD_WIDTH_PB, STANDARD_LSB_PB) |  \
+                        FIELD_MASK(STANDARD_WIDTH_PR, STANDARD_LSB_PR)) & \
+                       ~PREDICTED_HIGH)
+
+/* the values the widest field (a) can take */
+#define MAX_FIELD_SYMBOLS (1u << STANDARD_WIDTH_A)
+
+
+/*
+ * struct field
+ *      Where a field is in a word (the standard layout of word_layout.h),
+ *      whether it is coded as the difference from the same field of the 
+ *      word before, and the longest code it may have. a, pb_avg and pr_avg
+ *      change slowly from one block to the next; b, c and d are already 
+ *      small.
+ */
+static const struct field {
+        unsigned width, lsb;
+        bool predicted;
+        unsigned code_bits;
+} fields[ENTROPY_FIELDS] = {
+        { STANDARD_WIDTH_A, STANDARD_LSB_A, true, 12 },
+        { STANDARD_WIDTH_B, STANDARD_LSB_B, false, 10 },
+        { STANDARD_WIDTH_C, STANDARD_LSB_C, false, 10 },
+        { STANDARD_WIDTH_D, STANDARD_LSB_D, false, 10 },
+        { STANDARD_WIDTH_PB, STANDARD_LSB_PB, true, 8 },
+        { STANDARD_WIDTH_PR, STANDARD_LSB_PR, true, 8 }
+};
+
+/******** COMPRESSION HELPER FUNCTIONS ********/
+void word_to_symbols(uint32_t word, uint32_t previous, unsigned *symbols);
+unsigned residual_to_symbol(unsigned value, unsigned prediction,
+                            unsigned width);
+void counts_to_lengths(const uint32_t *counts, unsigned symbols,
+                       unsigned code_bits, unsigned char *lengths);
+void lengths_to_codes(const unsigned char *lengths, unsigned symbols,
+                      uint16_t *codes);
+void lengths_to_bytes(unsigned char lengths[][MAX_FIELD_SYMBOLS], 
+                      unsigned char *bytes);
+void write_stream_length(FILE *output, size_t length);
+
+/******** DECOMPRESSION HELPER FUNCTIONS ********/
+unsigned symbol_to_residual(unsigned symbol, const struct field *field);
+bool lengths_to_table(const unsigned char *lengths, const struct field *field,
+                      uint16_t *table);
+bool bytes_to_streams(const unsigned char *bytes, size_t length, 
+                      entropy_reader reader);
+static inline uint32_t stream_residuals(bit_reader stream, 
+                                        entropy_reader reader);
+static inline uint32_t residuals_to_word(uint32_t residuals, 
+                                         uint32_t previous);
+static inline unsigned stream_symbol(bit_reader stream, 
+                                     const uint16_t *table, 
+                                     unsigned code_bits);
+
+
+/************ COMPRESSION ************/
+
+/*
+*       Description: A function that writes count words to an output file
+*       entropy coded: the code lengths of every field, the lengths of the
+*       streams, then the streams. The words are read twice, once to count
+*       how often each value of each field is used and once to code them 
+*       into streams held in memory, which are written once they are done.
+*
+*       In/Out Expectations: Expects an output file open for writing, just
+*       after a header in format 5, and an array of count words in the
+*       order of format 2. Returns void.
+*/
+void write_entropy(FILE *output, uint32_t *words, size_t count) {
+        assert(output != NULL);
+        assert(words != NULL || count == 0);
+
+        uint32_t counts[ENTROPY_FIELDS][MAX_FIELD_SYMBOLS];
+        unsigned char lengths[ENTROPY_FIELDS][MAX_FIELD_SYMBOLS];
+        uint16_t codes[ENTROPY_FIELDS][MAX_FIELD_SYMBOLS];
+        unsigned symbols[ENTROPY_FIELDS];
+        memset(counts, 0, sizeof(counts));
+
+        uint32_t previous = 0;
+        for (size_t k = 0; k < count; k++) {
+                word_to_symbols(words[k], previous, symbols);
+                for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                        counts[f][symbols[f]]++;
+                }
+                previous = words[k];
+        }
+        for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                unsigned field_symbols = 1u << fields[f].width;
+                counts_to_lengths(counts[f], field_symbols, 
+                                  fields[f].code_bits, lengths[f]);
+                lengths_to_codes(lengths[f], field_symbols, codes[f]);
+        }
+
+        /* a word takes at most ENTROPY_FIELDS * MAX_CODE_BITS bits */
+        size_t capacity = (count / ENTROPY_STREAMS + 1) * ENTROPY_FIELDS * 
+                          MAX_CODE_BITS / CHAR_BITS + 1;
+        unsigned char *bytes = malloc(capacity * ENTROPY_STREAMS);
+        assert(bytes != NULL);
+        struct bit_writer writers[ENTROPY_STREAMS];
+        for (unsigned s = 0; s < ENTROPY_STREAMS; s++) {
+                open_bit_writer(&writers[s], bytes + s * capacity);
+        }
+
+        previous = 0;
+        for (size_t k = 0; k < count; k++) {
+                bit_writer writer = &writers[k % ENTROPY_STREAMS];
+                word_to_symbols(words[k], previous, symbols);
+                for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                        bit_writer_putu(writer, lengths[f][symbols[f]],
+                                        codes[f][symbols[f]]);
+                }
+                previous = words[k];
+        }
+
+        unsigned char table[ENTROPY_TABLE_BYTES];
+        lengths_to_bytes(lengths, table);
+        fwrite(table, 1, ENTROPY_TABLE_BYTES, output);
+        for (unsigned s = 0; s < ENTROPY_STREAMS; s++) {
+                size_t used = close_bit_writer(&writers[s]);
+                if (s + 1 < ENTROPY_STREAMS) {
+                        write_stream_length(output, used);
+                }
+        }
+        for (unsigned s = 0; s < ENTROPY_STREAMS; s++) {
+                fwrite(writers[s].bytes, 1, writers[s].used, output);
+        }
+        free(bytes);
+}
+
+/*
+*       Description: A function that gives the value coded for each field of
+*       a word.
+*
+*       In/Out Expectations: Expects a word, the word coded before it (0 for
+*       the first), and an array of ENTROPY_FIELDS symbols to set. Returns
+*       void.
+*/
+void word_to_symbols(uint32_t word, uint32_t previous, unsigned *symbols) {
+        for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                unsigned mask = (1u << fields[f].width) - 1;
+                unsigned value = (word >> fields[f].lsb) & mask;
+                if (fields[f].predicted) {
+                        value = residual_to_symbol(value, (previous >>
+                                fields[f].lsb) & mask, fields[f].width);
+                }
+                symbols[f] = value;
+        }
+}
+
+/*
+*       Description: A function that gives the symbol coding the difference
+*       between a field and its prediction, wrapped to the width of the
+*       field, so that small differences of either sign get small symbols:
+*       0, -1, 1, -2, 2 and so on.
+*
+*       In/Out Expectations: Expects a value and a prediction of width bits.
+*       Returns a symbol of width bits.
+*/
+unsigned residual_to_symbol(unsigned value, unsigned prediction,
+                            unsigned width) {
+        unsigned mask = (1u << width) - 1;
+        unsigned residual = (value - prediction) & mask;
+        if (residual < (1u << (width - 1))) {
+                return residual * 2;
+        }
+        return (mask - residual) * 2 + 1;
+}
+
+/*
+*       Description: A function that gives the length of the Huffman code
+*       of every symbol of a field from how often each is used, none of
+*       them longer than code_bits. If a code would be longer, the
+*       counts are halved (keeping every used symbol at least 1), which
+*       flattens the tree, and the code is built again.
+*
+*       In/Out Expectations: Expects the count of each of the symbols of a
+*       field, at most MAX_FIELD_SYMBOLS of them, the longest code allowed,
+*       enough for all of them, and an array of lengths to set, 0 for an 
+*       unused symbol. A single used symbol gets a length of
+*       1. Returns void.
+*/
+void counts_to_lengths(const uint32_t *counts, unsigned symbols,
+                       unsigned code_bits, unsigned char *lengths) {
+        uint64_t weights[2 * MAX_FIELD_SYMBOLS];
+        unsigned parents[2 * MAX_FIELD_SYMBOLS];
+        unsigned depths[2 * MAX_FIELD_SYMBOLS];
+        unsigned order[MAX_FIELD_SYMBOLS];
+        assert(symbols <= MAX_FIELD_SYMBOLS);
+
+        for (unsigned k = 0; k < symbols; k++) {
+                weights[k] = counts[k];
+        }
+        for (;;) {
+                unsigned used = 0;
+                for (unsigned k = 0; k < symbols; k++) {
+                        lengths[k] = 0;
+                        if (weights[k] == 0) {
+                                continue;
+                        }
+                        /* insertion sort, lightest first */
+                        unsigned at = used++;
+                        while (at > 0 && weights[order[at - 1]] > weights[k]) {
+                                order[at] = order[at - 1];
+                                at--;
+                        }
+                        order[at] = k;
+                }
+                if (used < 2) {
+                        if (used == 1) {
+                                lengths[order[0]] = 1;
+                        }
+                        return;
+                }
+
+                /*
+                 * the leaves, in order, and the nodes made from them, which
+                 * are made in order of weight too, form two sorted queues
+                 */
+                unsigned leaf = 0, first = symbols, next = symbols;
+                for (unsigned made = 0; made < used - 1; made++) {
+                        unsigned pick[2];
+                        for (int p = 0; p < 2; p++) {
+                                if (leaf < used && (first == next ||
+                                    weights[order[leaf]] <= weights[first])) {
+                                        pick[p] = order[leaf++];
+                                } else {
+                                        pick[p] = first++;
+                                }
+                        }
+                        weights[next] = weights[pick[0]] + weights[pick[1]];
+                        parents[pick[0]] = next;
+                        parents[pick[1]] = next;
+                        next++;
+                }
+
+                /* the root is made last, and every node after its children */
+                depths[next - 1] = 0;
+                for (unsigned node = next - 1; node-- > symbols;) {
+                        depths[node] = depths[parents[node]] + 1;
+                }
+                unsigned longest = 0;
+                for (unsigned k = 0; k < used; k++) {
+                        unsigned length = depths[parents[order[k]]] + 1;
+                        lengths[order[k]] = length;
+                        if (length > longest) {
+                                longest = length;
+                        }
+                }
+                if (longest <= code_bits) {
+                        return;
+                }
+                for (unsigned k = 0; k < symbols; k++) {
+                        weights[k] = (weights[k] + 1) / 2;
+                }
+        }
+}
+
+/*
+*       Description: A function that gives the canonical Huffman code of
+*       every symbol of a field from the lengths of the codes: shorter codes
+*       come first, and codes of the same length are in the order of their
+*       symbols, so the lengths alone are enough to rebuild them.
+*
+*       In/Out Expectations: Expects the code lengths of the symbols of a
+*       field, none longer than MAX_CODE_BITS, that a Huffman code can have,
+*       and an array of codes to set. Unused symbols are given no code.
+*       Returns void.
+*/
+void lengths_to_codes(const unsigned char *lengths, unsigned symbols,
+                      uint16_t *codes) {
+        unsigned length_counts[MAX_CODE_BITS + 1] = { 0 };
+        unsigned next_codes[MAX_CODE_BITS + 1];
+        for (unsigned k = 0; k < symbols; k++) {
+                length_counts[lengths[k]]++;
+        }
+        length_counts[0] = 0;
+
+        unsigned code = 0;
+        for (unsigned bits = 1; bits <= MAX_CODE_BITS; bits++) {
+                code = (code + length_counts[bits - 1]) << 1;
+                next_codes[bits] = code;
+        }
+        for (unsigned k = 0; k < symbols; k++) {
+                codes[k] = 0;
+                if (lengths[k] > 0) {
+                        codes[k] = next_codes[lengths[k]]++;
+                }
+        }
+}
+
+/*
+*       Description: A function that stores the code lengths of every value 
+*       of every field, two to a char, the first in the high bits.
+*
+*       In/Out Expectations: Expects the code lengths of each field and 
+*       room for ENTROPY_TABLE_BYTES chars. Returns void.
+*/
+void lengths_to_bytes(unsigned char lengths[][MAX_FIELD_SYMBOLS], 
+                      unsigned char *bytes) {
+        size_t nibble = 0;
+        for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                unsigned field_symbols = 1u << fields[f].width;
+                for (unsigned k = 0; k < field_symbols; k++, nibble++) {
+                        if (nibble % 2 == 0) {
+                                bytes[nibble / 2] = lengths[f][k] << 
+                                                    LENGTH_BITS;
+                        } else {
+                                bytes[nibble / 2] |= lengths[f][k];
+                        }
+                }
+        }
+}
+
+/*
+*       Description: A function that writes the length of a stream to an
+*       output file in STREAM_LENGTH_BYTES chars, most significant first.
+*
+*       In/Out Expectations: Expects an output file open for writing and 
+*       the length of a stream, in chars. Returns void.
+*/
+void write_stream_length(FILE *output, size_t length) {
+        unsigned char bytes[STREAM_LENGTH_BYTES];
+        uint64_t value = length;
+        for (unsigned k = STREAM_LENGTH_BYTES; k > 0; k--) {
+                bytes[k - 1] = value;
+                value >>= CHAR_BITS;
+        }
+        fwrite(bytes, 1, STREAM_LENGTH_BYTES, output);
+}
+
+/************ DECOMPRESSION ************/
+
+/*
+*       Description: A function that reads the code lengths of every field
+*       of an entropy coded image held in memory, builds the table each
+*       field is decoded with, and finds the streams.
+*
+*       In/Out Expectations: Expects an entropy_reader, which may be on the
+*       stack, and the length bytes that follow a header in format 5.
+*       Returns the number of bytes before the first stream, or 0 if they 
+*       are too short or the lengths of a field are not those of a prefix
+*       code.
+*/
+size_t open_entropy_reader(entropy_reader reader, const unsigned char *bytes,
+                           size_t length) {
+        assert(reader != NULL && bytes != NULL);
+        if (length < ENTROPY_TABLE_BYTES) {
+                return 0;
+        }
+
+        unsigned char lengths[MAX_FIELD_SYMBOLS];
+        size_t nibble = 0;
+        for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                unsigned field_symbols = 1u << fields[f].width;
+                for (unsigned k = 0; k < field_symbols; k++, nibble++) {
+                        unsigned char pair = bytes[nibble / 2];
+                        lengths[k] = nibble % 2 == 0 ? pair >> LENGTH_BITS :
+                                                       pair & 0xf;
+                }
+                if (!lengths_to_table(lengths, &fields[f], 
+                                      reader->codes[f])) {
+                        return 0;
+                }
+        }
+
+        if (!bytes_to_streams(bytes + ENTROPY_TABLE_BYTES, 
+                              length - ENTROPY_TABLE_BYTES, reader)) {
+                return 0;
+        }
+        reader->next = 0;
+        reader->previous = 0;
+        return ENTROPY_TABLE_BYTES + 
+               (ENTROPY_STREAMS - 1) * STREAM_LENGTH_BYTES;
+}
+
+/*
+*       Description: A function that builds the decoding table of a field:
+*       the entry for every code_bits bits that start with the code of a 
+*       symbol holds the residual the symbol codes (see symbol_to_residual)
+*       and the length of its code. Bits that start no code (only when a 
+*       field has a single symbol or none) decode to 0 without being used.
+*
+*       In/Out Expectations: Expects the code lengths of the symbols of a
+*       field, the field, and a table of 1 << code_bits entries to set. 
+*       Returns false if a length is too long or the codes would overlap.
+*/
+bool lengths_to_table(const unsigned char *lengths, const struct field *field,
+                      uint16_t *table) {
+        uint16_t codes[MAX_FIELD_SYMBOLS];
+        unsigned symbols = 1u << field->width;
+        unsigned code_bits = field->code_bits;
+        unsigned long space = 0;
+        for (unsigned k = 0; k < symbols; k++) {
+                if (lengths[k] > code_bits) {
+                        return false;
+                }
+                if (lengths[k] > 0) {
+                        space += 1ul << (code_bits - lengths[k]);
+                }
+        }
+        if (space > (1ul << code_bits)) {
+                return false;
+        }
+
+        memset(table, 0, sizeof(*table) << code_bits);
+        lengths_to_codes(lengths, symbols, codes);
+        for (unsigned k = 0; k < symbols; k++) {
+                if (lengths[k] == 0) {
+                        continue;
+                }
+                unsigned shift = code_bits - lengths[k];
+                unsigned first = (unsigned)codes[k] << shift;
+                unsigned residual = symbol_to_residual(k, field);
+                for (unsigned entry = 0; entry < (1u << shift); entry++) {
+                        table[first + entry] = residual << LENGTH_BITS | 
+                                               lengths[k];
+                }
+        }
+        return true;
+}
+
+/*
+*       Description: A function that reads the lengths of the streams and 
+*       readies a reader for each.
+*
+*       In/Out Expectations: Expects the length bytes that follow the code
+*       lengths and the entropy_reader whose streams to set. A stream cut
+*       short by the end of the bytes gets the chars that are there. Returns
+*       false if the bytes are too short to hold the stream lengths.
+*/
+bool bytes_to_streams(const unsigned char *bytes, size_t length, 
+                      entropy_reader reader) {
+        size_t index_length = (ENTROPY_STREAMS - 1) * STREAM_LENGTH_BYTES;
+        if (length < index_length) {
+                return false;
+        }
+
+        size_t position = index_length;
+        for (unsigned s = 0; s < ENTROPY_STREAMS; s++) {
+                uint64_t stream_length = length - position;
+                if (s + 1 < ENTROPY_STREAMS) {
+                        stream_length = 0;
+                        for (unsigned k = 0; k < STREAM_LENGTH_BYTES; k++) {
+                                stream_length = stream_length << CHAR_BITS |
+                                        bytes[s * STREAM_LENGTH_BYTES + k];
+                        }
+                }
+                if (stream_length > length - position) {
+                        stream_length = length - position;
+                }
+                open_bit_reader(&reader->streams[s], bytes + position, 
+                                stream_length, 0);
+                position += stream_length;
+        }
+        return true;
+}
+
+/*
+*       Description: A function that decodes the next count words of an
+*       entropy_reader, in the order they were written. Once the next word 
+*       is in the first stream, a word is decoded from each of the two 
+*       streams at once, each field of both before the next field, so the 
+*       lookups of one stream overlap those of the other. The streams are
+*       copied to locals while decoding so their bits stay in registers.
+*
+*       In/Out Expectations: Expects an opened entropy_reader and an array
+*       with room for count words. Bits missing from the end of a stream 
+*       are read as 0 bits, like the bytes missing from a file in another
+*       format; entropy_reader_valid tells if any were. Returns void.
+*/
+void entropy_words(entropy_reader reader, uint32_t *words, unsigned count) {
+        assert(reader != NULL);
+        assert(words != NULL || count == 0);
+
+        uint32_t previous = reader->previous;
+        unsigned k = 0;
+        if (count > 0 && reader->next % ENTROPY_STREAMS != 0) {
+                previous = residuals_to_word(stream_residuals(
+                        &reader->streams[1], reader), previous);
+                words[k++] = previous;
+        }
+
+        struct bit_reader even = reader->streams[0];
+        struct bit_reader odd = reader->streams[1];
+        for (; count - k >= ENTROPY_STREAMS; k += ENTROPY_STREAMS) {
+                uint32_t first = 0, second = 0;
+                for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                        if (f % FIELDS_PER_REFILL == 0) {
+                                refill_bit_reader(&even);
+                                refill_bit_reader(&odd);
+                        }
+                        first |= (uint32_t)stream_symbol(&even, 
+                                reader->codes[f], fields[f].code_bits) << 
+                                fields[f].lsb;
+                        second |= (uint32_t)stream_symbol(&odd, 
+                                reader->codes[f], fields[f].code_bits) << 
+                                fields[f].lsb;
+                }
+                previous = residuals_to_word(first, previous);
+                words[k] = previous;
+                previous = residuals_to_word(second, previous);
+                words[k + 1] = previous;
+        }
+        reader->streams[0] = even;
+        reader->streams[1] = odd;
+
+        if (k < count) {
+                previous = residuals_to_word(stream_residuals(
+                        &reader->streams[0], reader), previous);
+                words[k++] = previous;
+        }
+        reader->previous = previous;
+        reader->next += count;
+}
+
+/*
+*       Description: A function that tells if every bit an entropy_reader
+*       has decoded so far was in its streams.
+*
+*       In/Out Expectations: Expects an opened entropy_reader. Returns true
+*       if no bits past the end of any stream have been decoded.
+*/
+bool entropy_reader_valid(entropy_reader reader) {
+        assert(reader != NULL);
+        for (unsigned s = 0; s < ENTROPY_STREAMS; s++) {
+                if (!bit_reader_valid(&reader->streams[s])) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+/*
+*       Description: A function that decodes the residuals of the fields of
+*       one word from one stream.
+*
+*       In/Out Expectations: Expects the stream the word is in and the 
+*       entropy_reader whose tables to use. Returns the residuals, each in
+*       the bits of its field.
+*/
+static inline uint32_t stream_residuals(bit_reader stream, 
+                                        entropy_reader reader) {
+        uint32_t residuals = 0;
+        for (unsigned f = 0; f < ENTROPY_FIELDS; f++) {
+                if (f % FIELDS_PER_REFILL == 0) {
+                        refill_bit_reader(stream);
+                }
+                residuals |= (uint32_t)stream_symbol(stream, reader->codes[f],
+                                                     fields[f].code_bits) <<
+                             fields[f].lsb;
+        }
+        return residuals;
+}
+
+/*
+*       Description: A function that gives a word from the residuals of its
+*       fields and the word before it. The predicted fields are added to 
+*       the same fields of the word before all at once, without a carry 
+*       crossing from one field into the next: the top bit of each is left
+*       out of the add and put back with an exclusive or. The other fields
+*       are the residuals themselves.
+*
+*       In/Out Expectations: Expects the residuals of a word, each in the 
+*       bits of its field, and the word before it. Returns the word.
+*/
+static inline uint32_t residuals_to_word(uint32_t residuals, 
+                                         uint32_t previous) {
+        uint32_t sum = ((residuals & PREDICTED_LOW) + 
+                        (previous & PREDICTED_LOW)) ^ 
+                       ((residuals ^ previous) & PREDICTED_HIGH);
+        return (sum & (PREDICTED_LOW | PREDICTED_HIGH)) | 
+               (residuals & ~(PREDICTED_LOW | PREDICTED_HIGH));
+}
+
+/*
+*       Description: A function that decodes the next symbol of a stream 
+*       with one lookup in the table of its field.
+*
+*       In/Out Expectations: Expects a stream holding at least code_bits 
+*       bits, the table of the field, and the longest code of the field. 
+*       Returns the symbol.
+*/
+static inline unsigned stream_symbol(bit_reader stream, 
+                                     const uint16_t *table, 
+                                     unsigned code_bits) {
+        unsigned entry = table[bit_reader_peek(stream, code_bits)];
+        bit_reader_skip(stream, entry & 0xf);
+        return entry >> LENGTH_BITS;
+}
+
+/*
+*       Description: A function that gives the residual of a field a symbol
+*       codes, undoing residual_to_symbol: the difference from the 
+*       prediction, wrapped to the width of the field, for a predicted 
+*       field, and the symbol itself for any other.
+*
+*       In/Out Expectations: Expects a symbol of a field and the field. 
+*       Returns the residual, of the width of the field.
+*/
+unsigned symbol_to_residual(unsigned symbol, const struct field *field) {
+        unsigned mask = (1u << field->width) - 1;
+        if (!field->predicted) {
+                return symbol;
+        }
+        return symbol & 1 ? mask - (symbol >> 1) : symbol >> 1;
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+*       file_entropy.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains the declarations of the functions that write and
+*       read the words of an entropy coded image (format 5). The words are
+*       taken in the order of format 2, column by column, but instead of
+*       four chars per word each field of a word is written with a canonical
+*       Huffman code of its own: a, pb_avg and pr_avg as the difference from
+*       the same field of the word before, and b, c and d as they are. The
+*       code lengths of every field come first, two to a char, then the
+*       length of each stream but the last, then the streams. Word k is
+*       coded in stream k % ENTROPY_STREAMS, most significant bit first, so
+*       a decoder can decode an even and an odd word at once.
+*
+******************************************************************************/
+
+#ifndef FILE_ENTROPY_
+#define FILE_ENTROPY_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitstream.h"
+#include "word_layout.h"
+
+/* the fields of a word, each coded on its own: a, b, c, d, pb_avg, pr_avg */
+#define ENTROPY_FIELDS 6
+
+/* the longest code of any field, in bits */
+#define MAX_CODE_BITS 12
+
+/* the chars holding the code lengths of every value of every field */
+#define ENTROPY_TABLE_BYTES (((1u << STANDARD_WIDTH_A) +                  \
+                              (1u << STANDARD_WIDTH_B) +                  \
+                              (1u << STANDARD_WIDTH_C) +                  \
+                              (1u << STANDARD_WIDTH_D) +                  \
+                              (1u << STANDARD_WIDTH_PB) +                 \
+                              (1u << STANDARD_WIDTH_PR)) / 2)
+
+/* the streams the words are dealt to, and the chars of a stream length */
+#define ENTROPY_STREAMS 2
+#define STREAM_LENGTH_BYTES 8
+
+/*
+ * struct entropy_reader
+ *      A struct that decodes the words of an entropy coded image held in
+ *      memory: a bit_reader for each stream, the index of the next word, the
+ *      word decoded last, and a table for each field giving the residual and
+ *      the length of the code that starts with each run of bits as long as
+ *      the longest code of the field.
+ */
+typedef struct entropy_reader {
+        struct bit_reader streams[ENTROPY_STREAMS];
+        size_t next;
+        uint32_t previous;
+        uint16_t codes[ENTROPY_FIELDS][1 << MAX_CODE_BITS];
+} *entropy_reader;
+
+/********** COMPRESSION **********/
+void write_entropy(FILE *output, uint32_t *words, size_t count);
+
+/********** DECOMPRESSION **********/
+size_t open_entropy_reader(entropy_reader reader, const unsigned char *bytes,
+                           size_t length);
+void entropy_words(entropy_reader reader, uint32_t *words, unsigned count);
+bool entropy_reader_valid(entropy_reader reader);
+
+#endif
@@ -0,0 +1,134 @@
+/******************************************************************************
+*       file_progressive.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains the functions necessary to write the words of an
+*       image with their coarse fields before their detail fields
+*       (compression), and to read any run of them back from bytes held in
+*       memory (decompression). Every word has a fixed place in each part,
+*       so words can be read in any order, by several threads at once, like
+*       the words of format 2, and bits missing from the end of the bytes
+*       read as 0 bits. Both parts are written and read with the bit_writer
+*       and bit_reader of bitstream.h.
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "assert.h"
+#include "bitstream.h"
+#include "file_progressive.h"
+
+#define CHAR_BITS 8
+
+/*
+ * a sits above b, c and d in a word of the standard layout, and pb_avg and
+ * pr_avg below them, in the CHROMA_BITS low bits
+ */
+#define A_LSB STANDARD_LSB_A
+#define DETAIL_LSB STANDARD_LSB_D
+#define CHROMA_BITS STANDARD_LSB_D
+
+
+/************ COMPRESSION ************/
+
+/*
+*       Description: A function that gives the number of chars the words of
+*       a progressive image take after its header.
+*
+*       In/Out Expectations: Expects the number of words. Returns the number
+*       of chars.
+*/
+size_t progressive_length(size_t count) {
+        return (count * COARSE_BITS + CHAR_BITS - 1) / CHAR_BITS +
+               (count * DETAIL_BITS + CHAR_BITS - 1) / CHAR_BITS;
+}
+
+/*
+*       Description: A function that writes the words of an image to an
+*       output file, the coarse fields of every word before the detail
+*       fields of any.
+*
+*       In/Out Expectations: Expects an output file open for writing, just
+*       after a header in format 6, and the count words of the image, in the
+*       order of format 2. Mallocs the chars of both parts, which are freed
+*       once they are written. Returns void.
+*/
+void write_progressive(FILE *output, uint32_t *words, size_t count) {
+        assert(output != NULL);
+        assert(words != NULL || count == 0);
+
+        size_t length = progressive_length(count);
+        unsigned char *bytes = malloc(length + 1);
+        assert(bytes != NULL);
+
+        struct bit_writer coarse_writer, detail_writer;
+        open_bit_writer(&coarse_writer, bytes);
+        open_bit_writer(&detail_writer, bytes + (count * COARSE_BITS + 
+                                                 CHAR_BITS - 1) / CHAR_BITS);
+        for (size_t k = 0; k < count; k++) {
+                uint32_t word = words[k];
+                uint32_t coarse = (word >> A_LSB) << CHROMA_BITS |
+                                  (word & ((1u << CHROMA_BITS) - 1));
+                uint32_t detail = (word >> DETAIL_LSB) &
+                                  ((1u << DETAIL_BITS) - 1);
+                bit_writer_putu(&coarse_writer, COARSE_BITS, coarse);
+                bit_writer_putu(&detail_writer, DETAIL_BITS, detail);
+        }
+        close_bit_writer(&coarse_writer);
+        close_bit_writer(&detail_writer);
+
+        fwrite(bytes, 1, length, output);
+        free(bytes);
+}
+
+/************ DECOMPRESSION ************/
+
+/*
+*       Description: A function that converts count words of a progressive
+*       image held in memory, starting at word first, from their coarse and
+*       detail fields back to words. It does not change anything but the
+*       words, so several threads can convert different words at once.
+*
+*       In/Out Expectations: Expects the length chars that follow a header
+*       in format 6, the total number of words in the image, the index of
+*       the first word to convert, and an array with room for count words.
+*       Bits missing from the end of the chars are read as 0 bits, and a
+*       word whose detail fields are not all in the chars gets 0 detail
+*       rather than part of its fields, so an image cut short anywhere in
+*       its detail part gives every word its coarse fields. Returns void.
+*/
+void progressive_words(const unsigned char *bytes, size_t length,
+                       size_t total, size_t first, uint32_t *words,
+                       unsigned count) {
+        assert(bytes != NULL || length == 0);
+        assert(words != NULL || count == 0);
+
+        uint64_t detail_start = (total * COARSE_BITS + CHAR_BITS - 1) / 
+                                CHAR_BITS * CHAR_BITS;
+        uint64_t length_bits = (uint64_t)length * CHAR_BITS;
+        uint64_t whole_details = length_bits > detail_start ? 
+                (length_bits - detail_start) / DETAIL_BITS : 0;
+
+        struct bit_reader coarse_reader, detail_reader;
+        open_bit_reader(&coarse_reader, bytes, length, 
+                        (uint64_t)first * COARSE_BITS);
+        open_bit_reader(&detail_reader, bytes, length, 
+                        detail_start + (uint64_t)first * DETAIL_BITS);
+        for (unsigned k = 0; k < count; k++) {
+                uint32_t coarse = bit_reader_getu(&coarse_reader, 
+                                                  COARSE_BITS);
+                uint32_t detail = 0;
+                if (first + k < whole_details) {
+                        detail = bit_reader_getu(&detail_reader, 
+                                                 DETAIL_BITS);
+                }
+                words[k] = (coarse >> CHROMA_BITS) << A_LSB |
+                           detail << DETAIL_LSB |
+                           (coarse & ((1u << CHROMA_BITS) - 1));
+        }
+}
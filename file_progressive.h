@@ -0,0 +1,45 @@
+/******************************************************************************
+*       file_progressive.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains the declarations of the functions that write and
+*       read the words of a progressive image (format 6). The words are
+*       taken in the order of format 2, column by column, but split in two
+*       parts: first the coarse fields of every word (a, pb_avg and pr_avg,
+*       COARSE_BITS bits each), then the detail fields of every word (b, c
+*       and d, DETAIL_BITS bits each), each part packed most significant
+*       bit first and padded to a whole char. The file is as long as format
+*       2, give or take a char, but the first 17/32 of it already hold a
+*       whole image: with the detail missing, b, c and d read as 0 and each
+*       block decompresses to its average color.
+*
+******************************************************************************/
+
+#ifndef FILE_PROGRESSIVE_
+#define FILE_PROGRESSIVE_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "word_layout.h"
+
+/* 
+ * the bits of a word of the standard layout in the coarse part (a, pb_avg
+ * and pr_avg) and in the detail part (b, c and d)
+ */
+#define COARSE_BITS (STANDARD_WIDTH_A + STANDARD_WIDTH_PB + \
+                     STANDARD_WIDTH_PR)
+#define DETAIL_BITS (STANDARD_WIDTH_B + STANDARD_WIDTH_C + STANDARD_WIDTH_D)
+
+/********** COMPRESSION **********/
+size_t progressive_length(size_t count);
+void write_progressive(FILE *output, uint32_t *words, size_t count);
+
+/********** DECOMPRESSION **********/
+void progressive_words(const unsigned char *bytes, size_t length,
+                       size_t total, size_t first, uint32_t *words,
+                       unsigned count);
+
+#endif
@@ -0,0 +1,269 @@
+/******************************************************************************
+*       file_rgb.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the functions necessary to read the header of a 
+*       ppm file and then its pixels, one row at a time or all at once into
+*       an image held in memory (compression), and to write a binary ppm 
+*       file to an output file the same ways (decompression). Binary (P6) 
+*       pixels are moved with one fread or fwrite per image; plain (P3) 
+*       pixels are parsed as numbers. The bytes written are the ones 
+*       Pnm_ppmwrite writes for the same image.
+*   
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "assert.h"
+#include "pnm.h"
+#include "file_rgb.h"
+
+#define MAX_DENOMINATOR 65535
+#define ONE_BYTE_DENOMINATOR 255
+#define CHAR_BITS 8
+
+/******** COMPRESSION HELPER FUNCTIONS ********/
+unsigned read_ppm_number(FILE *input);
+unsigned read_ppm_sample(FILE *input, unsigned denominator);
+void read_plain_pixels(FILE *input, arith40_image image);
+
+/******** DECOMPRESSION HELPER FUNCTIONS ********/
+void write_ppm_sample(FILE *output, unsigned sample, unsigned denominator);
+
+
+/************ COMPRESSION ************/
+
+/*
+*       Description: A function that reads the header of a ppm file, 
+*       leaving the input positioned at the first char of the first pixel.
+*
+*       In/Out Expectations: Expects a valid input file that has been 
+*       sucessfully opened, whose header starts with the magic number P6 or
+*       P3. Sets the width, height and denominator, passed by reference, to
+*       the values in the header. Returns the kind of the file, PPM_RAW or 
+*       PPM_PLAIN.
+*/
+unsigned read_ppm_header(FILE *input, unsigned *width, unsigned *height, 
+                         unsigned *denominator) {
+        assert(input != NULL);
+        assert(width != NULL && height != NULL && denominator != NULL);
+
+        int first = getc(input);
+        int second = getc(input);
+        assert(first == 'P');
+        assert(second == '0' + PPM_RAW || second == '0' + PPM_PLAIN);
+
+        *width = read_ppm_number(input);
+        *height = read_ppm_number(input);
+        *denominator = read_ppm_number(input);
+        assert(*denominator > 0 && *denominator <= MAX_DENOMINATOR);
+        return second - '0';
+}
+
+/*
+*       Description: A function that reads every pixel of a ppm file into an
+*       image held in memory. Binary pixels are already laid out the way the
+*       image holds them, so they are read with one fread when the rows of 
+*       the image are next to each other, otherwise one per row.
+*
+*       In/Out Expectations: Expects an input file positioned at the first 
+*       pixel, the kind read_ppm_header returned, and an image with the 
+*       width, height and denominator of the header and room for every 
+*       pixel. Asserts that the file holds every pixel. Returns void.
+*/
+void read_ppm_pixels(FILE *input, unsigned kind, arith40_image image) {
+        assert(input != NULL);
+        assert(image != NULL && image->pixels != NULL);
+
+        if (kind == PPM_PLAIN) {
+                read_plain_pixels(input, image);
+                return;
+        }
+
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        size_t row_bytes = (size_t)image->width * 3 * sample_bytes;
+        if (image->stride == row_bytes) {
+                size_t read = fread(image->pixels, 1, row_bytes * 
+                                    image->height, input);
+                assert(read == row_bytes * image->height);
+                return;
+        }
+        for (unsigned row = 0; row < image->height; row++) {
+                size_t read = fread(image->pixels + row * image->stride, 1, 
+                                    row_bytes, input);
+                assert(read == row_bytes);
+        }
+}
+
+/*
+*       Description: A function that reads every pixel of a plain ppm file,
+*       where each sample is a number, into an image held in memory.
+*
+*       In/Out Expectations: Expects an input file positioned at the first 
+*       pixel and an image like read_ppm_pixels expects. Returns void.
+*/
+void read_plain_pixels(FILE *input, arith40_image image) {
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+
+        for (unsigned row = 0; row < image->height; row++) {
+                unsigned char *bytes = image->pixels + row * image->stride;
+                for (unsigned k = 0; k < image->width * 3; k++) {
+                        unsigned sample = read_ppm_number(input);
+                        if (sample_bytes == 2) {
+                                *bytes++ = sample >> CHAR_BITS;
+                        }
+                        *bytes++ = sample;
+                }
+        }
+}
+
+/*
+*       Description: A function that reads the next row of pixels of a binary
+*       ppm file.
+*
+*       In/Out Expectations: Expects an input file positioned at the start of
+*       a row, the width and denominator from its header, and an array with 
+*       room for width Pnm_rgbs, which are set from the file. Returns void.
+*/
+void read_ppm_row(FILE *input, unsigned width, unsigned denominator, 
+                  struct Pnm_rgb *row) {
+        assert(input != NULL);
+        assert(row != NULL);
+
+        for (unsigned i = 0; i < width; i++) {
+                row[i].red = read_ppm_sample(input, denominator);
+                row[i].green = read_ppm_sample(input, denominator);
+                row[i].blue = read_ppm_sample(input, denominator);
+        }
+}
+
+/*
+*       Description: A function that reads an unsigned number from a ppm 
+*       header, skipping whitespace and comments before it.
+*
+*       In/Out Expectations: Expects an input file positioned in a ppm 
+*       header or plain pixels. Reads the number and the one whitespace char
+*       after it, so after the denominator the file is at the first pixel;
+*       the last number of a file may end it instead. Returns the number.
+*/
+unsigned read_ppm_number(FILE *input) {
+        int c = getc(input);
+        while (isspace(c) || c == '#') {
+                if (c == '#') {
+                        while (c != '\n' && c != EOF) {
+                                c = getc(input);
+                        }
+                }
+                c = getc(input);
+        }
+        assert(isdigit(c));
+
+        unsigned n = 0;
+        while (isdigit(c)) {
+                n = n * 10 + (c - '0');
+                c = getc(input);
+        }
+        assert(isspace(c) || c == EOF);
+        return n;
+}
+
+/*
+*       Description: A function that reads one sample of a pixel, which is 
+*       one char if the denominator fits in a byte and two chars (most 
+*       significant first) otherwise.
+*
+*       In/Out Expectations: Expects an input file positioned at a sample and
+*       the denominator from its header. Returns the sample.
+*/
+unsigned read_ppm_sample(FILE *input, unsigned denominator) {
+        int c = getc(input);
+        assert(c != EOF);
+        if (denominator <= ONE_BYTE_DENOMINATOR) {
+                return c;
+        }
+
+        int low = getc(input);
+        assert(low != EOF);
+        return ((unsigned)c << CHAR_BITS) | (unsigned)low;
+}
+
+
+/************ DECOMPRESSION ************/
+
+/*
+*       Description: A function that writes the header of a binary ppm file
+*       to an output file.
+*
+*       In/Out Expectations: Expects an output file open for writing, and the
+*       width, height and denominator of the image. No return value.
+*/
+void write_ppm_header(FILE *output, unsigned width, unsigned height, 
+                      unsigned denominator) {
+        assert(output != NULL);
+        assert(denominator > 0 && denominator <= MAX_DENOMINATOR);
+        fprintf(output, "P6\n%u %u\n%u\n", width, height, denominator);
+}
+
+/*
+*       Description: A function that writes the next row of pixels of a 
+*       binary ppm file to an output file.
+*
+*       In/Out Expectations: Expects an output file open for writing and an
+*       array of width Pnm_rgbs, each no greater than the denominator written
+*       in the header. No return value.
+*/
+void write_ppm_row(FILE *output, struct Pnm_rgb *row, unsigned width, 
+                   unsigned denominator) {
+        assert(output != NULL);
+        assert(row != NULL);
+
+        for (unsigned i = 0; i < width; i++) {
+                write_ppm_sample(output, row[i].red, denominator);
+                write_ppm_sample(output, row[i].green, denominator);
+                write_ppm_sample(output, row[i].blue, denominator);
+        }
+}
+
+/*
+*       Description: A function that writes one sample of a pixel to an 
+*       output file, as one char if the denominator fits in a byte and two 
+*       chars (most significant first) otherwise.
+*
+*       In/Out Expectations: Expects an output file open for writing, a 
+*       sample and the denominator of its image. No return value.
+*/
+void write_ppm_sample(FILE *output, unsigned sample, unsigned denominator) {
+        if (denominator > ONE_BYTE_DENOMINATOR) {
+                putc(sample >> CHAR_BITS, output);
+        }
+        putc(sample & ONE_BYTE_DENOMINATOR, output);
+}
+
+/*
+*       Description: A function that writes every pixel of an image held in 
+*       memory to a binary ppm file, with one fwrite when the rows of the 
+*       image are next to each other, otherwise one per row.
+*
+*       In/Out Expectations: Expects an output file open for writing, whose
+*       header has been written with the width, height and maxval of the 
+*       image. No return value.
+*/
+void write_ppm_pixels(FILE *output, arith40_image image) {
+        assert(output != NULL);
+        assert(image != NULL && image->pixels != NULL);
+
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        size_t row_bytes = (size_t)image->width * 3 * sample_bytes;
+        if (image->stride == row_bytes) {
+                fwrite(image->pixels, 1, row_bytes * image->height, output);
+                return;
+        }
+        for (unsigned row = 0; row < image->height; row++) {
+                fwrite(image->pixels + row * image->stride, 1, row_bytes, 
+                       output);
+        }
+}
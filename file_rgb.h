@@ -0,0 +1,40 @@
+/******************************************************************************
+*       file_rgb.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the function declarations for reading a binary 
+*       (P6) ppm file one row of Pnm_rgb pixels at a time, and for writing 
+*       one the same way, so an image can be compressed or decompressed 
+*       without holding all of it in memory.
+*   
+******************************************************************************/
+
+#ifndef FILE_RGB_
+#define FILE_RGB_
+
+#include <stdio.h>
+#include "pnm.h"
+#include "buffer40.h"
+
+/* the kinds of ppm file, named for the digit of their magic number */
+#define PPM_PLAIN 3
+#define PPM_RAW 6
+
+/********** COMPRESSION **********/
+unsigned read_ppm_header(FILE *input, unsigned *width, unsigned *height, 
+                         unsigned *denominator);
+void read_ppm_row(FILE *input, unsigned width, unsigned denominator, 
+                  struct Pnm_rgb *row);
+void read_ppm_pixels(FILE *input, unsigned kind, arith40_image image);
+
+/********** DECOMPRESSION **********/
+void write_ppm_header(FILE *output, unsigned width, unsigned height, 
+                      unsigned denominator);
+void write_ppm_row(FILE *output, struct Pnm_rgb *row, unsigned width, 
+                   unsigned denominator);
+void write_ppm_pixels(FILE *output, arith40_image image);
+
+#endif
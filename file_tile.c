@@ -0,0 +1,298 @@
+/******************************************************************************
+*       file_tile.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*   
+*       Comp40 Project 4: arith
+*   
+*       This file contains the functions necessary to lay an image out in
+*       tiles and write their index to a file (compression), and to read the
+*       index from bytes held in memory and check each tile against it
+*       (decompression). Every tile is checked with a CRC32C of its chars,
+*       computed a byte at a time from a table built on first use.
+*   
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "assert.h"
+#include "file_word.h"
+#include "file_tile.h"
+
+#define BLOCK_SIZE 2
+#define BYTES_PER_WORD 4
+#define CHAR_BITS 8
+#define OFFSET_BYTES 8
+#define LENGTH_BYTES 4
+#define CRC_BYTES 4
+
+/* the Castagnoli polynomial, bits reversed */
+#define CRC32C_POLYNOMIAL 0x82F63B78
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_table_once = PTHREAD_ONCE_INIT;
+
+/******** COMPRESSION HELPER FUNCTIONS ********/
+void unsigned_to_bytes(uint64_t value, unsigned count, unsigned char *bytes);
+uint32_t words_crc32c(uint32_t *words, size_t count);
+
+/******** DECOMPRESSION HELPER FUNCTIONS ********/
+uint64_t bytes_to_unsigned64(const unsigned char *bytes, unsigned count);
+void build_crc_table(void);
+
+
+/************ COMPRESSION ************/
+
+/*
+*       Description: A function that lays out the tiles of an image.
+*
+*       In/Out Expectations: Expects a tile_index, which may be on the
+*       stack, the number of block columns and rows of the image, and the
+*       side of a tile in blocks, which is not 0. Sets the layout of the
+*       index; entries and data are set to NULL. Returns void.
+*/
+void layout_tiles(tile_index index, unsigned columns, unsigned rows,
+                  unsigned tile_blocks) {
+        assert(index != NULL);
+        assert(tile_blocks > 0);
+
+        index->columns = columns;
+        index->rows = rows;
+        index->tile_blocks = tile_blocks;
+        index->tile_columns = ((uint64_t)columns + tile_blocks - 1) / 
+                              tile_blocks;
+        index->tile_rows = ((uint64_t)rows + tile_blocks - 1) / tile_blocks;
+        index->entries = NULL;
+        index->data = NULL;
+        index->data_length = 0;
+}
+
+/*
+*       Description: A function that gives the blocks a tile covers, and
+*       where its words are when every tile holds four chars per block, the
+*       way compression stores them: each tile row after the last, and each
+*       tile after the one to its left.
+*
+*       In/Out Expectations: Expects a laid out tile_index, the index of a
+*       tile, counted row by row, and a tile to set. The CRC of the tile is
+*       set to 0. Returns void.
+*/
+void tile_at(tile_index index, size_t k, tile curr_tile) {
+        assert(index != NULL && curr_tile != NULL);
+        assert(k < (size_t)index->tile_columns * index->tile_rows);
+
+        unsigned tile_row = k / index->tile_columns;
+        unsigned tile_col = k % index->tile_columns;
+
+        curr_tile->first_col = tile_col * index->tile_blocks;
+        curr_tile->first_row = tile_row * index->tile_blocks;
+        curr_tile->end_col = curr_tile->first_col + index->tile_blocks;
+        curr_tile->end_row = curr_tile->first_row + index->tile_blocks;
+        if (curr_tile->end_col > index->columns) {
+                curr_tile->end_col = index->columns;
+        }
+        if (curr_tile->end_row > index->rows) {
+                curr_tile->end_row = index->rows;
+        }
+
+        unsigned height = curr_tile->end_row - curr_tile->first_row;
+        unsigned width = curr_tile->end_col - curr_tile->first_col;
+        uint64_t words_before = (uint64_t)curr_tile->first_row *
+                                index->columns +
+                                (uint64_t)curr_tile->first_col * height;
+        curr_tile->offset = words_before * BYTES_PER_WORD;
+        curr_tile->length = width * height * BYTES_PER_WORD;
+        curr_tile->crc = 0;
+}
+
+/*
+*       Description: A function that writes the line with the side of a
+*       tile and the index entry of every tile to an output file, computing
+*       the CRC of each tile from its words.
+*
+*       In/Out Expectations: Expects an output file open for writing, just
+*       after a header in format 4, a laid out tile_index, and the words of
+*       every tile, in the order tile_at lays them out. Returns void.
+*/
+void write_tile_index(FILE *output, tile_index index, uint32_t *words) {
+        assert(output != NULL && index != NULL);
+
+        fprintf(output, "%u\n", index->tile_blocks);
+
+        size_t count = (size_t)index->tile_columns * index->tile_rows;
+        for (size_t k = 0; k < count; k++) {
+                struct tile curr_tile;
+                unsigned char entry[TILE_ENTRY_BYTES];
+
+                tile_at(index, k, &curr_tile);
+                curr_tile.crc = words_crc32c(words + curr_tile.offset /
+                                             BYTES_PER_WORD,
+                                             curr_tile.length /
+                                             BYTES_PER_WORD);
+                unsigned_to_bytes(curr_tile.offset, OFFSET_BYTES, entry);
+                unsigned_to_bytes(curr_tile.length, LENGTH_BYTES,
+                                  entry + OFFSET_BYTES);
+                unsigned_to_bytes(curr_tile.crc, CRC_BYTES,
+                                  entry + OFFSET_BYTES + LENGTH_BYTES);
+                fwrite(entry, 1, TILE_ENTRY_BYTES, output);
+        }
+}
+
+/*
+*       Description: A function that stores an unsigned value in count
+*       bytes, most significant byte first.
+*
+*       In/Out Expectations: Expects a value that fits in count bytes and
+*       room for count bytes. Returns void.
+*/
+void unsigned_to_bytes(uint64_t value, unsigned count, unsigned char *bytes) {
+        for (unsigned k = count; k > 0; k--) {
+                bytes[k - 1] = value;
+                value >>= CHAR_BITS;
+        }
+}
+
+/*
+*       Description: A function that computes the CRC32C of the chars count
+*       words are written as.
+*
+*       In/Out Expectations: Expects an array of count words. Returns the
+*       CRC.
+*/
+uint32_t words_crc32c(uint32_t *words, size_t count) {
+        uint32_t crc = 0;
+        for (size_t k = 0; k < count; k++) {
+                unsigned char bytes[BYTES_PER_WORD];
+                word_to_bytes(words[k], bytes);
+                crc = crc32c(crc, bytes, BYTES_PER_WORD);
+        }
+        return crc;
+}
+
+/************ DECOMPRESSION ************/
+
+/*
+*       Description: A function that reads the tile line and finds the
+*       index entries and the tiles of a tiled image held in memory.
+*
+*       In/Out Expectations: Expects the length bytes that follow a header
+*       in format 4, the width and height the header gives, in pixels, and
+*       a tile_index to set. Returns the number of bytes in the tile line
+*       and the index, or 0 if they are not valid or the bytes are too short
+*       to hold them.
+*/
+size_t bytes_to_tile_index(const unsigned char *bytes, size_t length,
+                           unsigned width, unsigned height,
+                           tile_index index) {
+        assert(bytes != NULL && index != NULL);
+
+        size_t position = 0;
+        unsigned tile_blocks;
+        if (!bytes_to_unsigned(bytes, length, &position, &tile_blocks) ||
+            tile_blocks == 0 || position >= length ||
+            bytes[position] != '\n') {
+                return 0;
+        }
+        position++;
+
+        layout_tiles(index, width / BLOCK_SIZE, height / BLOCK_SIZE, 
+                     tile_blocks);
+        size_t count = (size_t)index->tile_columns * index->tile_rows;
+        bool blocks = index->columns > 0 && index->rows > 0;
+        if ((blocks && count == 0) || 
+            (length - position) / TILE_ENTRY_BYTES < count) {
+                return 0;
+        }
+        index->entries = bytes + position;
+        position += count * TILE_ENTRY_BYTES;
+        index->data = bytes + position;
+        index->data_length = length - position;
+        return position;
+}
+
+/*
+*       Description: A function that gives a tile of a tiled image held in
+*       memory and checks it: its entry must give four chars per block, all
+*       of them must be in memory, and their CRC must be the one in the
+*       entry.
+*
+*       In/Out Expectations: Expects a tile_index set by bytes_to_tile_index,
+*       the index of a tile, counted row by row, and a tile to set. Returns
+*       true if the tile is valid, otherwise false.
+*/
+bool index_to_tile(tile_index index, size_t k, tile curr_tile) {
+        assert(index != NULL && index->entries != NULL);
+
+        tile_at(index, k, curr_tile);
+        uint64_t length = (uint64_t)BYTES_PER_WORD * 
+                          (curr_tile->end_col - curr_tile->first_col) *
+                          (curr_tile->end_row - curr_tile->first_row);
+
+        const unsigned char *entry = index->entries +
+                                     (size_t)k * TILE_ENTRY_BYTES;
+        curr_tile->offset = bytes_to_unsigned64(entry, OFFSET_BYTES);
+        curr_tile->length = bytes_to_unsigned64(entry + OFFSET_BYTES,
+                                                LENGTH_BYTES);
+        curr_tile->crc = bytes_to_unsigned64(entry + OFFSET_BYTES +
+                                             LENGTH_BYTES, CRC_BYTES);
+
+        if (curr_tile->length != length ||
+            curr_tile->offset > index->data_length ||
+            curr_tile->length > index->data_length - curr_tile->offset) {
+                return false;
+        }
+        return crc32c(0, index->data + curr_tile->offset,
+                      curr_tile->length) == curr_tile->crc;
+}
+
+/*
+*       Description: A function that reads an unsigned value stored in
+*       count bytes, most significant byte first.
+*
+*       In/Out Expectations: Expects at least count bytes, at most 8.
+*       Returns the value.
+*/
+uint64_t bytes_to_unsigned64(const unsigned char *bytes, unsigned count) {
+        uint64_t value = 0;
+        for (unsigned k = 0; k < count; k++) {
+                value = value << CHAR_BITS | bytes[k];
+        }
+        return value;
+}
+
+/*
+*       Description: A function that continues a CRC32C (the Castagnoli
+*       CRC, used by iSCSI and ext4) over length more bytes.
+*
+*       In/Out Expectations: Expects the CRC of the bytes before, 0 to
+*       start, and an array of length bytes. Returns the CRC of all of them.
+*/
+uint32_t crc32c(uint32_t crc, const unsigned char *bytes, size_t length) {
+        pthread_once(&crc_table_once, build_crc_table);
+
+        crc = ~crc;
+        for (size_t k = 0; k < length; k++) {
+                crc = crc_table[(crc ^ bytes[k]) & 0xff] ^ (crc >> CHAR_BITS);
+        }
+        return ~crc;
+}
+
+/*
+*       Description: A function that builds the table crc32c uses, the CRC
+*       of every byte value.
+*
+*       In/Out Expectations: Run once, by pthread_once. Returns void.
+*/
+void build_crc_table(void) {
+        for (uint32_t value = 0; value < 256; value++) {
+                uint32_t crc = value;
+                for (int bit = 0; bit < CHAR_BITS; bit++) {
+                        crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLYNOMIAL :
+                                        crc >> 1;
+                }
+                crc_table[value] = crc;
+        }
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+*       file_tile.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*   
+*       Comp40 Project 4: arith
+*   
+*       This file contains the declarations of the functions that read and
+*       write the index of a tiled compressed image (format 4). After the
+*       header, a tiled file holds a line with the side of a tile, in
+*       blocks, then one index entry per tile, then the words of every tile.
+*       Tiles are stored row by row, left to right, and the words of a tile
+*       row by row inside it, so each tile can be found, checked and
+*       decompressed without reading any other one.
+*   
+******************************************************************************/
+
+#ifndef FILE_TILE_
+#define FILE_TILE_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* the side of a tile, in blocks, when compressing */
+#define TILE_BLOCKS 64
+
+/*
+ * the bytes in an index entry: the offset of the tile from the first char
+ * of the first tile (8 bytes), its length (4 bytes) and the CRC32C of its
+ * chars (4 bytes), each most significant byte first
+ */
+#define TILE_ENTRY_BYTES 16
+
+/*
+ * struct tile_index
+ *      A struct that holds the layout of the tiles of an image: the number
+ *      of block columns and rows of the image, the side of a tile in
+ *      blocks, and the number of tile columns and rows. When read from
+ *      memory, entries points at the first index entry and data at the
+ *      first char of the first tile, with data_length chars from there to
+ *      the end of the input.
+ */
+typedef struct tile_index {
+        unsigned columns, rows;
+        unsigned tile_blocks;
+        unsigned tile_columns, tile_rows;
+        const unsigned char *entries;
+        const unsigned char *data;
+        size_t data_length;
+} *tile_index;
+
+/*
+ * struct tile
+ *      A struct that holds one tile: the block columns [first_col, end_col)
+ *      and block rows [first_row, end_row) it covers, and its index entry.
+ */
+typedef struct tile {
+        unsigned first_col, end_col;
+        unsigned first_row, end_row;
+        uint64_t offset;
+        uint32_t length;
+        uint32_t crc;
+} *tile;
+
+/********** COMPRESSION **********/
+void layout_tiles(tile_index index, unsigned columns, unsigned rows,
+                  unsigned tile_blocks);
+void tile_at(tile_index index, size_t k, tile curr_tile);
+void write_tile_index(FILE *output, tile_index index, uint32_t *words);
+
+/********** DECOMPRESSION **********/
+size_t bytes_to_tile_index(const unsigned char *bytes, size_t length,
+                           unsigned width, unsigned height,
+                           tile_index index);
+bool index_to_tile(tile_index index, size_t k, tile curr_tile);
+uint32_t crc32c(uint32_t crc, const unsigned char *bytes, size_t length);
+
+#endif
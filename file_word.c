@@ -7,7 +7,8 @@
 *   
 *       This file contains the functions necessary to read words from a file 
 *       and store them in a word_pixmap (decompression), and write words 
-*       stored in a word_pixmap to a file (compression). 
+*       stored in a word_pixmap to a file (compression). It also converts
+*       headers and words to and from bytes held in memory.
 *   
 ******************************************************************************/
 
@@ -15,6 +16,12 @@
 #include <math.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <a2methods.h>
 #include "assert.h"
 #include "a2blocked.h"
@@ -27,14 +34,19 @@
 #define MAX_BITS 32
 #define CHAR_BITS 8
 #define BLOCK_SIZE 2
+#define HEADER_FORMAT "COMP40 Compressed image format %u\n%u %u\n"
+#define HEADER_PREFIX "COMP40 Compressed image format "
 
 /******** COMPRESSION HELPER FUNCTIONS ********/
 void write_word_mapping(int i, int j, A2Methods_UArray2 array2, 
                 A2Methods_Object *word, void *cl);
+void flush_word_writer(word_writer writer);
 
 /******** DECOMPRESSION HELPER FUNCTIONS ********/
 void read_word_mapping(int i, int j, A2Methods_UArray2 array2, 
-                A2Methods_Object *word, void *fp);
+                A2Methods_Object *word, void *cl);
+uint32_t read_word(FILE *input);
+void map_word_reader(word_reader reader);
 
 
 
@@ -42,43 +54,222 @@ void read_word_mapping(int i, int j, A2Methods_UArray2 array2,
 
 /*
 *       Description: A function that writes the file header and calls a mapping
-*       function that writes word bits as characters to an output file
+*       function that writes word bits as characters to an output file, 
+*       through a word_writer.
 *   
 *       In/Out Expectations: Expects a valid type word_pixmap storing a 2D
-*       array of words, which are of type uint32_t. No outputs. Expects that
-*       the word_pixmap has an even number of rows and columns. 
+*       array of words, which are of type uint32_t, and an output file open
+*       for writing. No outputs. Expects that the word_pixmap has an even 
+*       number of rows and columns. 
 */
-void write_to_file(word_pixmap pixmap) {
+void write_to_file(word_pixmap pixmap, FILE *output) {
         assert(pixmap != NULL);
+        assert(output != NULL);
 
         pixmap->methods = uarray2_methods_blocked;
-        printf("COMP40 Compressed image format 2\n%u %u\n", 
-                pixmap->width * BLOCK_SIZE, pixmap->height * BLOCK_SIZE);
+        write_header(output, FORMAT_COLUMNS, pixmap->width * BLOCK_SIZE, 
+                     pixmap->height * BLOCK_SIZE);
+        struct word_writer writer;
+        open_word_writer(&writer, output);
         pixmap->methods->map_block_major(pixmap->pixels, write_word_mapping,
-                NULL);
+                &writer);
+        close_word_writer(&writer);
+}
+
+/*
+*       Description: A function that writes the file header for an image of 
+*       the given format, width and height to an output file.
+*   
+*       In/Out Expectations: Expects an output file open for writing, one of
+*       the formats in file_word.h and an even width and height, in pixels.
+*       No return value.
+*/
+void write_header(FILE *output, unsigned format, unsigned width, 
+                  unsigned height) {
+        assert(output != NULL);
+        assert(format == FORMAT_COLUMNS || format == FORMAT_ROWS || 
+               format == FORMAT_TILES || format == FORMAT_ENTROPY || 
+               format == FORMAT_PROGRESSIVE || format == FORMAT_FINE);
+        fprintf(output, HEADER_FORMAT, format, width, height);
+}
+
+/*
+*       Description: A function that writes the header of a compressed image
+*       to bytes held in memory, the same way write_header writes it to a
+*       file.
+*   
+*       In/Out Expectations: Expects one of the formats in file_word.h, an
+*       even width and height, in pixels, and an array of length bytes. 
+*       Returns the number of bytes written, or 0 if the header does not 
+*       fit, in which case nothing is written.
+*/
+size_t header_to_bytes(unsigned format, unsigned width, unsigned height,
+                       unsigned char *bytes, size_t length) {
+        assert(bytes != NULL);
+        assert(format == FORMAT_COLUMNS || format == FORMAT_ROWS || 
+               format == FORMAT_TILES || format == FORMAT_ENTROPY || 
+               format == FORMAT_PROGRESSIVE || format == FORMAT_FINE);
+
+        char header[MAX_HEADER_LENGTH];
+        int written = snprintf(header, MAX_HEADER_LENGTH, HEADER_FORMAT, 
+                               format, width, height);
+        assert(written > 0 && written < MAX_HEADER_LENGTH);
+        if ((size_t)written > length) {
+                return 0;
+        }
+        memcpy(bytes, header, written);
+        return written;
+}
+
+/*
+*       Description: A function that stores the four chars of a word in 
+*       memory, most significant byte first, the order they are written to 
+*       a file in. Shifts are used instead of Bitpack_getu so a loop of 
+*       these can be compiled to byte swaps.
+*   
+*       In/Out Expectations: expects to take in a word, which is a uint32_t,
+*       and an array with room for four bytes. No return values. 
+*/
+void word_to_bytes(uint32_t word, unsigned char *bytes) {
+        bytes[0] = word >> (MAX_BITS - CHAR_BITS);
+        bytes[1] = word >> (MAX_BITS - 2 * CHAR_BITS);
+        bytes[2] = word >> CHAR_BITS;
+        bytes[3] = word;
+}
+
+/*
+*       Description: A function that writes a buffer of words to an output
+*       file, in the order they are stored in the buffer, through a 
+*       word_writer of its own.
+*   
+*       In/Out Expectations: Expects an output file open for writing and an
+*       array of at least count words, which are of type uint32_t. Writes 
+*       four chars per word to the output file. No return value.
+*/
+void write_words(FILE *output, uint32_t *words, unsigned count) {
+        assert(output != NULL);
+        assert(words != NULL);
+
+        struct word_writer writer;
+        open_word_writer(&writer, output);
+        writer_words(&writer, words, count);
+        close_word_writer(&writer);
+}
+
+/*
+*       Description: A function that readies a word_writer to write to an 
+*       output file.
+*   
+*       In/Out Expectations: Expects a word_writer, which may be on the 
+*       stack, and an output file open for writing. The writer must be 
+*       closed with close_word_writer before anything else is written to
+*       the file. No return value.
+*/
+void open_word_writer(word_writer writer, FILE *output) {
+        assert(writer != NULL);
+        assert(output != NULL);
+
+        writer->output = output;
+        writer->used = 0;
+}
+
+/*
+*       Description: A function that converts words to their four chars, 
+*       most significant byte first, into the buffer of a word_writer, 
+*       writing the buffer to the output file each time it fills up.
+*   
+*       In/Out Expectations: Expects an open word_writer and an array of at
+*       least count words. No return value.
+*/
+void writer_words(word_writer writer, uint32_t *words, unsigned count) {
+        assert(writer != NULL);
+        assert(words != NULL);
+
+        while (count > 0) {
+                size_t room = sizeof(writer->bytes) - writer->used;
+                unsigned n = room / sizeof(*words);
+                if (n > count) {
+                        n = count;
+                }
+                unsigned char *bytes = writer->bytes + writer->used;
+                for (unsigned k = 0; k < n; k++) {
+                        word_to_bytes(words[k], bytes + k * sizeof(*words));
+                }
+                writer->used += n * sizeof(*words);
+                words += n;
+                count -= n;
+
+                if (writer->used == sizeof(writer->bytes)) {
+                        flush_word_writer(writer);
+                }
+        }
+}
+
+/*
+*       Description: A function that writes what is left in the buffer of a
+*       word_writer to the output file.
+*   
+*       In/Out Expectations: Expects an open word_writer, which is closed 
+*       after this. No return value.
+*/
+void close_word_writer(word_writer writer) {
+        assert(writer != NULL);
+        flush_word_writer(writer);
+}
+
+/*
+*       Description: A function that empties the buffer of a word_writer 
+*       into the output file. After the file's own buffer is flushed, the 
+*       chars go straight to its file descriptor with write(), so the whole
+*       buffer is written at once. A file without a descriptor, or an error
+*       from write(), falls back to fwrite, which sets the error indicator
+*       of the file if writing fails there too.
+*   
+*       In/Out Expectations: Expects an open word_writer. Leaves the buffer
+*       empty. No return value.
+*/
+void flush_word_writer(word_writer writer) {
+        size_t written = 0;
+        int fd = fileno(writer->output);
+
+        if (writer->used > 0 && fd >= 0 && fflush(writer->output) == 0) {
+                while (written < writer->used) {
+                        ssize_t n = write(fd, writer->bytes + written, 
+                                          writer->used - written);
+                        if (n < 0 && errno == EINTR) {
+                                continue;
+                        }
+                        if (n <= 0) {
+                                break;
+                        }
+                        written += n;
+                }
+        }
+        if (written < writer->used) {
+                fwrite(writer->bytes + written, 1, writer->used - written, 
+                       writer->output);
+        }
+        writer->used = 0;
 }
 
 /*
 *       Description: A function that takes an element of a word_pixmap, and 
-*       writes four corresponding chars to standard output. 
+*       writes four corresponding chars to an output file. 
 *   
 *       In/Out Expectations: expects to take in an word element, which is a 
-*       unint32_t, from a 2D array of words. Writes four chars to standard
-*       output. No return values. 
+*       unint32_t, from a 2D array of words, and an open word_writer as the
+*       closure. Writes four chars to the writer. No return values. 
 */
 void write_word_mapping(int i, int j, A2Methods_UArray2 array2, 
                      A2Methods_Object *word, void *cl) {
+        assert(cl != NULL);
         uint32_t *curr_word = (uint32_t*)word;
 
-        for (int i = MAX_BITS - CHAR_BITS; i >= 0; i = (i - CHAR_BITS)) {
-                uint64_t c = Bitpack_getu(*curr_word, CHAR_BITS, i);
-                putchar(c);
-        }
+        writer_words((word_writer)cl, curr_word, 1);
 
         (void)i;
         (void)j;
         (void)array2;
-        (void)cl;
 }
 
 
@@ -93,57 +284,403 @@ void write_word_mapping(int i, int j, A2Methods_UArray2 array2,
 *       In/Out Expectations: Expects a valid output file that has 
 *       been sucessfully opened. Expects a valid header of this file that
 *       gives the height and with of the number of words encoded as chars.
-*       Mallocs space for a new word_pixmap and returns this 2D array. 
+*       Allocates the new word_pixmap in the given arena, which frees it 
+*       when it is reset, and returns this 2D array. 
 */
-word_pixmap read_from_file(FILE *input) {
+word_pixmap read_from_file(FILE *input, Arena40_T arena) {
         assert(input != NULL);
 
-        unsigned height, width;
-        int read = fscanf(input, "COMP40 Compressed image format 2\n%u %u",
-                          &width, &height);
-        assert(read == 2);
-        int c = getc(input);
-        assert(c == '\n');
+        struct word_reader reader;
+        open_word_reader(&reader, input);
+        assert(reader.format == FORMAT_COLUMNS);
+        unsigned width = reader.width;
+        unsigned height = reader.height;
 
-        word_pixmap new_word_pixmap = malloc(sizeof(*new_word_pixmap));
-        assert(new_word_pixmap);
+        word_pixmap new_word_pixmap = Arena40_alloc(arena, 
+                                                    sizeof(*new_word_pixmap));
 
         new_word_pixmap->width = width / BLOCK_SIZE;
         new_word_pixmap->height = height / BLOCK_SIZE;
         new_word_pixmap->methods = uarray2_methods_blocked;
 
         uint32_t dummy_uint32;
-        A2Methods_UArray2 pixmap = new_word_pixmap->methods->
-                new_with_blocksize(width / BLOCK_SIZE, height / BLOCK_SIZE, 
-                sizeof(dummy_uint32), COMPRESSED_BLOCK_SIZE);
+        A2Methods_UArray2 pixmap = UArray2b_new_in(arena, width / BLOCK_SIZE,
+                height / BLOCK_SIZE, sizeof(dummy_uint32), 
+                COMPRESSED_BLOCK_SIZE);
         new_word_pixmap->pixels = pixmap;
 
         new_word_pixmap->methods->map_block_major(new_word_pixmap->pixels, 
-                read_word_mapping, input);
+                read_word_mapping, &reader);
+        close_word_reader(&reader);
         return new_word_pixmap;
 }
 
+/*
+*       Description: A function that readies a word_reader for the words of
+*       an input file, reading and checking its header. A regular file is 
+*       mapped into memory, and its header is checked in the mapping; any 
+*       other file has its header read by read_header. The words of an 
+*       entropy coded file can only be decoded in order, from memory, so 
+*       such a file is loaded if it is not mapped, and its code lengths are
+*       read.
+*   
+*       In/Out Expectations: Expects a word_reader, which may be on the 
+*       stack, and an input file positioned at the start of a header in one
+*       of the formats in file_word.h. Sets the format, width and height of
+*       the reader. A mapped file keeps its position, and a progressive or
+*       entropy coded file that is not mapped is loaded. Asserts that the 
+*       code lengths of an entropy coded file are valid. The reader must be
+*       closed with close_word_reader. No return value.
+*/
+void open_word_reader(word_reader reader, FILE *input) {
+        assert(reader != NULL);
+        assert(input != NULL);
+
+        reader->input = input;
+        reader->next = 0;
+        reader->words = NULL;
+        reader->length = 0;
+        reader->mapping = NULL;
+        reader->mapping_length = 0;
+        reader->loaded = false;
+        reader->entropy = NULL;
+
+        map_word_reader(reader);
+        if (reader->mapping == NULL) {
+                reader->format = read_header(input, &reader->width, 
+                                             &reader->height);
+        }
+        if (reader->format == FORMAT_ENTROPY) {
+                load_word_reader(reader);
+                reader->entropy = malloc(sizeof(*reader->entropy));
+                assert(reader->entropy != NULL);
+                size_t tables = open_entropy_reader(reader->entropy, 
+                                                    reader->words, 
+                                                    reader->length);
+                assert(tables > 0);
+        } else if (reader->format == FORMAT_PROGRESSIVE) {
+                load_word_reader(reader);
+        }
+}
+
+/*
+*       Description: A function that maps a regular input file into memory
+*       and checks the header at its current position there, leaving the 
+*       reader unmapped if the file cannot be mapped.
+*   
+*       In/Out Expectations: Expects a word_reader being opened. Asserts 
+*       that a mapped file starts with a valid header. No return value.
+*/
+void map_word_reader(word_reader reader) {
+        struct stat info;
+        int fd = fileno(reader->input);
+        off_t offset = ftell(reader->input);
+        if (fd < 0 || offset < 0 || fstat(fd, &info) != 0 || 
+            !S_ISREG(info.st_mode) || info.st_size <= offset) {
+                return;
+        }
+
+        void *mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, 
+                             fd, 0);
+        if (mapping == MAP_FAILED) {
+                return;
+        }
+        reader->mapping = mapping;
+        reader->mapping_length = info.st_size;
+
+        const unsigned char *header = (const unsigned char *)mapping + offset;
+        size_t length = info.st_size - offset;
+        size_t header_length = bytes_to_header(header, length, 
+                &reader->format, &reader->width, &reader->height);
+        assert(header_length > 0);
+        reader->words = header + header_length;
+        reader->length = length - header_length;
+}
+
+/*
+*       Description: A function that reads the rest of the file of a 
+*       word_reader into memory if it is not mapped, so its words can be 
+*       found anywhere in it like they can in a mapped file.
+*   
+*       In/Out Expectations: Expects an open word_reader none of whose words
+*       have been read yet. Mallocs the memory, which close_word_reader 
+*       frees. No return value.
+*/
+void load_word_reader(word_reader reader) {
+        assert(reader != NULL);
+        if (reader->words != NULL) {
+                return;
+        }
+
+        size_t capacity = WRITER_WORDS * sizeof(uint32_t);
+        size_t length = 0;
+        unsigned char *bytes = malloc(capacity);
+        assert(bytes != NULL);
+        for (;;) {
+                length += fread(bytes + length, 1, capacity - length, 
+                                reader->input);
+                if (length < capacity) {
+                        break;
+                }
+                capacity *= 2;
+                bytes = realloc(bytes, capacity);
+                assert(bytes != NULL);
+        }
+
+        reader->mapping = bytes;
+        reader->mapping_length = capacity;
+        reader->loaded = true;
+        reader->words = bytes;
+        reader->length = length;
+}
+
+/*
+*       Description: A function that gives the next count words of a 
+*       word_reader, in the order they are stored in the file, decoding 
+*       them if the file is entropy coded.
+*   
+*       In/Out Expectations: Expects an open word_reader and an array with 
+*       room for count words. Bytes missing from the end of the file are 
+*       left as zero bits, like read_words does. Returns void.
+*/
+void reader_words(word_reader reader, uint32_t *words, unsigned count) {
+        assert(reader != NULL);
+
+        if (reader->entropy != NULL) {
+                entropy_words(reader->entropy, words, count);
+        } else if (reader->words == NULL) {
+                read_words(reader->input, words, count);
+        } else {
+                reader_words_at(reader, reader->next, words, count);
+        }
+        reader->next += count;
+}
+
+/*
+*       Description: A function that converts count words of a mapped file,
+*       starting at word first, from big-endian chars in the mapping (or 
+*       from the two parts of a progressive file) to words, all in one 
+*       loop. It does not move the reader, so several threads can convert 
+*       different words of the same file at once.
+*   
+*       In/Out Expectations: Expects a word_reader whose file is mapped and
+*       not entropy coded, and an array with room for count words. Bytes
+*       missing from the end of the file are left as zero bits, like 
+*       read_words does. Returns void.
+*/
+void reader_words_at(word_reader reader, size_t first, uint32_t *words, 
+                     unsigned count) {
+        assert(reader != NULL && reader->words != NULL);
+        assert(reader->entropy == NULL);
+        assert(words != NULL);
+
+        if (reader->format == FORMAT_PROGRESSIVE) {
+                size_t total = (size_t)(reader->width / BLOCK_SIZE) * 
+                               (reader->height / BLOCK_SIZE);
+                progressive_words(reader->words, reader->length, total, 
+                                  first, words, count);
+                return;
+        }
+
+        size_t whole = reader->length / sizeof(*words);
+        const unsigned char *bytes = reader->words + first * sizeof(*words);
+        unsigned k = 0;
+        for (; k < count && first + k < whole; k++) {
+                words[k] = bytes_to_word(bytes + k * sizeof(*words));
+        }
+        for (; k < count; k++) {
+                unsigned char last[sizeof(*words)] = { 0, 0, 0, 0 };
+                size_t start = (first + k) * sizeof(*words);
+                if (start < reader->length) {
+                        memcpy(last, reader->words + start, 
+                               reader->length - start);
+                }
+                words[k] = bytes_to_word(last);
+        }
+}
+
+/*
+*       Description: A function that unmaps the file of a word_reader, if it
+*       was mapped, or frees it, if it was loaded.
+*   
+*       In/Out Expectations: Expects an open word_reader, which is closed 
+*       after this. The input file is left open. Returns void.
+*/
+void close_word_reader(word_reader reader) {
+        assert(reader != NULL);
+
+        if (reader->loaded) {
+                free(reader->mapping);
+        } else if (reader->mapping != NULL) {
+                munmap(reader->mapping, reader->mapping_length);
+        }
+        free(reader->entropy);
+        reader->mapping = NULL;
+        reader->loaded = false;
+        reader->words = NULL;
+        reader->entropy = NULL;
+}
+
+/*
+*       Description: A function that reads the header of a compressed file,
+*       leaving the input positioned at the first char of the first word.
+*   
+*       In/Out Expectations: Expects a valid input file that has been 
+*       sucessfully opened and an unsigned width and height, passed by
+*       reference, which are set to the image size given in the header.
+*       Returns the format of the file, which is one of the formats in
+*       file_word.h.
+*/
+unsigned read_header(FILE *input, unsigned *width, unsigned *height) {
+        assert(input != NULL);
+        assert(width != NULL && height != NULL);
+
+        unsigned format;
+        int read = fscanf(input, "COMP40 Compressed image format %u\n%u %u",
+                          &format, width, height);
+        assert(read == 3);
+        assert(format == FORMAT_COLUMNS || format == FORMAT_ROWS || 
+               format == FORMAT_TILES || format == FORMAT_ENTROPY || 
+               format == FORMAT_PROGRESSIVE || format == FORMAT_FINE);
+        int c = getc(input);
+        assert(c == '\n');
+        return format;
+}
+
+/*
+*       Description: A function that reads count words from an input file
+*       into a buffer, in the order they are stored in the file.
+*   
+*       In/Out Expectations: Expects a valid input file positioned at the
+*       start of a word, and an array with room for count words. Bytes 
+*       missing from the end of the file are left as zero bits, like
+*       read_word_mapping does. Returns void.
+*/
+void read_words(FILE *input, uint32_t *words, unsigned count) {
+        assert(input != NULL);
+        assert(words != NULL);
+
+        for (unsigned k = 0; k < count; k++) {
+                words[k] = read_word(input);
+        }
+}
+
+/*
+*       Description: A function that reads the header of a compressed image
+*       from bytes held in memory, accepting the headers read_header does.
+*   
+*       In/Out Expectations: Expects an array of length bytes, which need 
+*       not end with a null character, and an unsigned format, width and 
+*       height, passed by reference, which are set from the header. Returns
+*       the number of bytes in the header, or 0 if the bytes do not start 
+*       with a header in one of the formats in file_word.h.
+*/
+size_t bytes_to_header(const unsigned char *bytes, size_t length, 
+                       unsigned *format, unsigned *width, unsigned *height) {
+        assert(bytes != NULL);
+        assert(format != NULL && width != NULL && height != NULL);
+
+        size_t position = strlen(HEADER_PREFIX);
+        if (length < position || memcmp(bytes, HEADER_PREFIX, position) != 0
+            || !bytes_to_unsigned(bytes, length, &position, format)
+            || !bytes_to_unsigned(bytes, length, &position, width)
+            || !bytes_to_unsigned(bytes, length, &position, height)) {
+                return 0;
+        }
+        if (*format != FORMAT_COLUMNS && *format != FORMAT_ROWS && 
+            *format != FORMAT_TILES && *format != FORMAT_ENTROPY &&
+            *format != FORMAT_PROGRESSIVE && *format != FORMAT_FINE) {
+                return 0;
+        }
+        if (position >= length || bytes[position] != '\n') {
+                return 0;
+        }
+        return position + 1;
+}
+
+/*
+*       Description: A function that embeds four chars held in memory in a 
+*       word, most significant byte first, like read_word does from a file.
+*       Shifts are used instead of Bitpack_newu so a loop of these can be 
+*       compiled to byte swaps.
+*   
+*       In/Out Expectations: Expects an array of at least four bytes. 
+*       Returns the word as a uint32_t.
+*/
+uint32_t bytes_to_word(const unsigned char *bytes) {
+        return (uint32_t)bytes[0] << (MAX_BITS - CHAR_BITS) |
+               (uint32_t)bytes[1] << (MAX_BITS - 2 * CHAR_BITS) |
+               (uint32_t)bytes[2] << CHAR_BITS |
+               (uint32_t)bytes[3];
+}
+
+/*
+*       Description: A function that reads an unsigned decimal number from 
+*       bytes held in memory, skipping whitespace before it like fscanf.
+*   
+*       In/Out Expectations: Expects an array of length bytes, the position
+*       to start at, passed by reference, which is moved past the number,
+*       and an unsigned value, passed by reference, which is set to it. 
+*       Returns false if there is no number or it does not fit an unsigned.
+*/
+bool bytes_to_unsigned(const unsigned char *bytes, size_t length, 
+                       size_t *position, unsigned *value) {
+        size_t k = *position;
+        while (k < length && (bytes[k] == ' ' || bytes[k] == '\t' || 
+                              bytes[k] == '\n' || bytes[k] == '\r')) {
+                k++;
+        }
+        if (k >= length || bytes[k] < '0' || bytes[k] > '9') {
+                return false;
+        }
+
+        uint64_t number = 0;
+        while (k < length && bytes[k] >= '0' && bytes[k] <= '9') {
+                number = number * 10 + (bytes[k] - '0');
+                if (number > UINT_MAX) {
+                        return false;
+                }
+                k++;
+        }
+        *value = number;
+        *position = k;
+        return true;
+}
+
+/*
+*       Description: A function that reads four chars from an input file and 
+*       imbeds them in a word, most significant byte first.
+*   
+*       In/Out Expectations: Expects a valid input file positioned at the
+*       start of a word. Returns the word as a uint32_t.
+*/
+uint32_t read_word(FILE *input) {
+        uint32_t word = 0;
+        for (int i = MAX_BITS - CHAR_BITS; i >= 0; i = (i - CHAR_BITS)) {
+                int c = getc(input);
+                if (c >= 0){
+                        word = Bitpack_newu(word, CHAR_BITS, i, (uint64_t)c);
+                }
+        }
+        return word;
+}
+
 /*
 *       Description: A function that takes an element of a word_pixmap, and 
 *       gets four corresponding bits and imbeddeds them into a uint32_t. This
 *       uint32_t will be stored in an corresponding element of the word_pixmap. 
 *   
 *       In/Out Expectations: expects to take in an word element, which is a 
-*       unint32_t, that is initially zero. Expects that four characters can 
-*       be read from a valid input file. Sets the current word. No return val.
+*       unint32_t, that is initially zero, and an open word_reader as the 
+*       closure, which gives the next word. Sets the current word. No return
+*       val.
 */
 void read_word_mapping(int i, int j, A2Methods_UArray2 array2, 
-                     A2Methods_Object *word, void *fp) {
-        assert(fp != NULL);
-        FILE *input = (FILE*)fp;  
+                     A2Methods_Object *word, void *cl) {
+        assert(cl != NULL);
+        word_reader reader = (word_reader)cl;  
         uint32_t *curr_word = (uint32_t*)word;
-        for (int i = MAX_BITS - CHAR_BITS; i >= 0; i = (i - CHAR_BITS)) {
-                int c = getc(input);
-                if (c >= 0){
-                        *curr_word = Bitpack_newu(*curr_word, CHAR_BITS, 
-                                i, (uint64_t)c);
-                }
-        }  
+        reader_words(reader, curr_word, 1);
             
         (void)i;
         (void)j;
@@ -2,14 +2,107 @@
 #define FILE_WORD_
 
 #include <stdio.h>
+#include <stdbool.h>
+#include <sys/types.h>
 #include <a2methods.h>
+#include "arena40.h"
 #include "bitpack.h"
 #include "word_unpacked.h"
+#include "file_entropy.h"
+#include "file_progressive.h"
+
+/* 
+ * The compressed formats, named for the order their words are stored in.
+ * Format 2 is the one in the Arith40 spec: column by column, top to bottom.
+ * Format 3 stores the words row by row, left to right, so an image can be 
+ * compressed or decompressed two pixel rows at a time.
+ * Format 4 stores the words in tiles, after an index of the tiles, so each
+ * tile can be found and decompressed on its own (see file_tile.h).
+ * Format 5 stores the words in the order of format 2, each field entropy 
+ * coded, so the file is smaller but can only be decoded in order (see 
+ * file_entropy.h).
+ * Format 6 stores the words in the order of format 2, the coarse fields of
+ * every word before the detail fields of any, so the first half of the file
+ * already gives the whole image at low detail (see file_progressive.h).
+ * Format 7 stores words of the fine layout, 64 bits each, in the order of 
+ * format 2 (see word_layout.h).
+ */
+#define FORMAT_COLUMNS 2
+#define FORMAT_ROWS 3
+#define FORMAT_TILES 4
+#define FORMAT_ENTROPY 5
+#define FORMAT_PROGRESSIVE 6
+#define FORMAT_FINE 7
+
+/* the most bytes a header can take, whatever its format, width and height */
+#define MAX_HEADER_LENGTH 64
+
+/* the number of words a word_writer holds before writing them */
+#define WRITER_WORDS 16384
+
+/* 
+ * struct word_writer
+ *      A struct that collects the chars of words before they are written to
+ *      an output file, so the file is written in a few large pieces instead
+ *      of a char at a time. It is small enough to live on the stack.
+ */
+typedef struct word_writer {
+        FILE *output;
+        size_t used;
+        unsigned char bytes[WRITER_WORDS * sizeof(uint32_t)];
+} *word_writer;
+
+/* 
+ * struct word_reader
+ *      A struct that reads the words of a compressed file after checking 
+ *      its header once. A regular file is mapped into memory: words points
+ *      at the chars of the first word inside the mapping and length is the
+ *      number of chars from there to the end of the file, so words are 
+ *      converted straight from the page cache without being copied. Any 
+ *      other file (a pipe, say) is read with stdio, and words is NULL, 
+ *      unless the rest of the file is loaded into memory, which loaded 
+ *      says. next is the index of the next word reader_words gives. The 
+ *      words of an entropy coded file are decoded by entropy, which is 
+ *      NULL for every other format.
+ */
+typedef struct word_reader {
+        FILE *input;
+        unsigned format, width, height;
+        const unsigned char *words;
+        size_t length;
+        size_t next;
+        void *mapping;
+        size_t mapping_length;
+        bool loaded;
+        entropy_reader entropy;
+} *word_reader;
 
 /********** COMPRESSION **********/
-void write_to_file(word_pixmap pixmap);
+void write_to_file(word_pixmap pixmap, FILE *output);
+void write_header(FILE *output, unsigned format, unsigned width, 
+                  unsigned height);
+void write_words(FILE *output, uint32_t *words, unsigned count);
+void open_word_writer(word_writer writer, FILE *output);
+void writer_words(word_writer writer, uint32_t *words, unsigned count);
+void close_word_writer(word_writer writer);
+size_t header_to_bytes(unsigned format, unsigned width, unsigned height,
+                       unsigned char *bytes, size_t length);
+void word_to_bytes(uint32_t word, unsigned char *bytes);
 
 /********** DECOMPRESSION **********/
-word_pixmap read_from_file(FILE *input);
+word_pixmap read_from_file(FILE *input, Arena40_T arena);
+void open_word_reader(word_reader reader, FILE *input);
+void load_word_reader(word_reader reader);
+void reader_words(word_reader reader, uint32_t *words, unsigned count);
+void reader_words_at(word_reader reader, size_t first, uint32_t *words, 
+                     unsigned count);
+void close_word_reader(word_reader reader);
+unsigned read_header(FILE *input, unsigned *width, unsigned *height);
+void read_words(FILE *input, uint32_t *words, unsigned count);
+size_t bytes_to_header(const unsigned char *bytes, size_t length, 
+                       unsigned *format, unsigned *width, unsigned *height);
+uint32_t bytes_to_word(const unsigned char *bytes);
+bool bytes_to_unsigned(const unsigned char *bytes, size_t length, 
+                       size_t *position, unsigned *value);
 
 #endif
\ No newline at end of file
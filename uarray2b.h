@@ -1,6 +1,8 @@
 #ifndef UARRAY2B_INCLUDED
 #define UARRAY2B_INCLUDED
 
+#include "arena40.h"
+
 #define T UArray2b_T
 typedef struct T *T;
 
@@ -16,6 +18,13 @@ extern T    UArray2b_new (int width, int height, int size, int blocksize);
  */
 extern T    UArray2b_new_64K_block(int width, int height, int size);
 
+/* 
+ * new blocked 2d array allocated in an arena, which frees it when the 
+ * arena is reset or disposed; UArray2b_free only clears the pointer
+ */
+extern T    UArray2b_new_in(Arena40_T arena, int width, int height, int size,
+                            int blocksize);
+
 extern void  UArray2b_free     (T *array2b);
 
 extern int   UArray2b_width    (T  array2b);
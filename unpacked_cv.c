@@ -22,39 +22,21 @@
 #include "arith40.h"
 #include "cv_rgb.h"
 #include "unpacked_cv.h"
+#include "word_layout.h"
 
 #define BLOCK_SIZE 2
 #define COMPRESSED_BLOCK_SIZE 1
 
-/* 
- * struct unpacked_data
- *      This is a struct to be used as a closure in the mapping functions. It
- *      contains an unpacked_pixmap pixmap, 3 float arrays for the pb, pr, and
- *      y values of the 4 pixels in each block, and a counter (used to 
- *      determine when the 4 pixels have all been seen)
- */
-struct unpacked_data{
-        unpacked_pixmap pixmap;
-        float pb_values[BLOCK_SIZE * BLOCK_SIZE];
-        float pr_values[BLOCK_SIZE * BLOCK_SIZE];
-        float y_values[BLOCK_SIZE * BLOCK_SIZE];
-        int counter;
-};
-
-
 /******** COMPRESSION HELPER FUNCTIONS ********/
 void cv_to_unpacked_mapping(int i, int j, A2Methods_UArray2 array2, 
                 A2Methods_Object *cv, void *unpacked_pixmap);
-void cv_to_unpacked(struct unpacked_data *block_data, unpacked_t curr);
-signed scaled_val(float val);
+signed scaled_val(float val, word_layout layout);
 float average_values(float values[]);
 
 /******** DECOMPRESSION HELPER FUNCTIONS ********/
 void unpacked_to_cv_mapping(int i, int j, A2Methods_UArray2 array2, 
                 A2Methods_Object *cv, void *old_unpacked_pixmap);
-void calculate_y_vals(unpacked_t curr_unpacked, 
-                struct unpacked_data *block_data);
-float unscaled_val(signed val);
+float unscaled_val(signed val, word_layout layout);
 
 
 /************ COMPRESSION ************/
@@ -65,28 +47,27 @@ float unscaled_val(signed val);
 *       unpacked_pixmap containing a 2D array of unpacked_ts, where every
 *       four cv_ts are associated with one struct unpacked_t.
 *
-*       In/Out Expectations: Expects a struct type cv_pixmap. Mallocs
-*       memory for a struct unpacked_pixmap that the client must eventually 
-*       free. Returns this created type of unpacked_pixmap.  
+*       In/Out Expectations: Expects a struct type cv_pixmap and an arena.
+*       Allocates the struct unpacked_pixmap in the arena, which frees it 
+*       when it is reset. Returns this created type of unpacked_pixmap.  
 */
-unpacked_pixmap cv_to_unpacked_pixmap(cv_pixmap old_cv_pixmap) {
+unpacked_pixmap cv_to_unpacked_pixmap(cv_pixmap old_cv_pixmap, 
+                                      Arena40_T arena) {
         assert(old_cv_pixmap != NULL);
 
         int width = old_cv_pixmap->width / BLOCK_SIZE;
         int height = old_cv_pixmap->height / BLOCK_SIZE;
 
         unpacked_pixmap new_unpacked_pixmap = 
-                malloc(sizeof(*new_unpacked_pixmap));
-        assert(new_unpacked_pixmap != NULL);
+                Arena40_alloc(arena, sizeof(*new_unpacked_pixmap));
 
         new_unpacked_pixmap->width = width;
         new_unpacked_pixmap->height = height;
         new_unpacked_pixmap->methods = uarray2_methods_blocked; 
 
         unpacked_t dummy_unpacked;
-        A2Methods_UArray2 pixmap = new_unpacked_pixmap->methods->
-                new_with_blocksize(width, height, sizeof(*dummy_unpacked),
-                COMPRESSED_BLOCK_SIZE);
+        A2Methods_UArray2 pixmap = UArray2b_new_in(arena, width, height, 
+                sizeof(*dummy_unpacked), COMPRESSED_BLOCK_SIZE);
         new_unpacked_pixmap->pixels = pixmap;
 
         struct unpacked_data block_data;
@@ -138,7 +119,7 @@ void cv_to_unpacked_mapping(int i, int j, A2Methods_UArray2 array2,
 
 /*
 *       Description: Generates a unpacked_t from a populated
-*       struct of type block_data.
+*       struct of type block_data, quantized for the standard layout.
 *
 *       In/Out Expectations: expects a pointer to a struct block_data
 *       which must have been already populated with data from four cv_ts.
@@ -146,13 +127,29 @@ void cv_to_unpacked_mapping(int i, int j, A2Methods_UArray2 array2,
 *       from the associated block_data struct. Returns void.
 */
 void cv_to_unpacked(struct unpacked_data *block_data, unpacked_t curr) {
+        cv_to_unpacked_in(&standard_layout, block_data, curr);
+}
+
+/*
+*       Description: Generates a unpacked_t from a populated
+*       struct of type block_data, quantized for the given layout.
+*
+*       In/Out Expectations: expects a layout, a pointer to a struct 
+*       block_data which must have been already populated with data from 
+*       four cv_ts, and an instance of unpacked_t. Sets values of the 
+*       unpacked_t from the associated block_data struct, each fitting in 
+*       its field of the layout. Returns void.
+*/
+void cv_to_unpacked_in(word_layout layout, struct unpacked_data *block_data,
+                       unpacked_t curr) {
+        assert(layout != NULL);
         assert(block_data != NULL);
         assert(curr != NULL);
 
         float pb_avg_temp = average_values(block_data->pb_values);
         float pr_avg_temp = average_values(block_data->pr_values);
-        unsigned pb_avg = Arith40_index_of_chroma(pb_avg_temp);
-        unsigned pr_avg = Arith40_index_of_chroma(pr_avg_temp);
+        unsigned pb_avg = layout_index_of_chroma(layout, pb_avg_temp);
+        unsigned pr_avg = layout_index_of_chroma(layout, pr_avg_temp);
         
         /* 
          * Note that y_values[1] represents Y2 and y_values[2] represents Y3,
@@ -171,10 +168,10 @@ void cv_to_unpacked(struct unpacked_data *block_data, unpacked_t curr) {
                         block_data->y_values[2] + block_data->y_values[0]) / 
                         (BLOCK_SIZE * BLOCK_SIZE);
 
-        unsigned a = a_temp * 511;
-        signed b = scaled_val(b_temp);
-        signed c = scaled_val(c_temp);
-        signed d = scaled_val(d_temp);
+        unsigned a = a_temp * layout->a_max;
+        signed b = scaled_val(b_temp, layout);
+        signed c = scaled_val(c_temp, layout);
+        signed d = scaled_val(d_temp, layout);
 
         curr->a = a;
         curr->b = b;
@@ -185,18 +182,21 @@ void cv_to_unpacked(struct unpacked_data *block_data, unpacked_t curr) {
 }
 
 /*
-*       Description: Scales a float to a signed value between 15 and -15
+*       Description: Scales a float to a signed value in steps of the 
+*       layout, between -15 and 15 in the standard layout
 *
 *       In/Out Expectations: expects a float (most commonly between -0.3
-*       and 0.3). Returns a signed value between -15 and 15. 
+*       and 0.3, in the standard layout) and a layout. Returns a signed 
+*       value that fits in the b, c and d fields of the layout.
 */
-signed scaled_val(float val) {
-        if (val >= 0.3) {
-                return 15;
-        } else if (val <= -0.3) {
-                return -15;
+signed scaled_val(float val, word_layout layout) {
+        signed limit = (1 << (layout->b.width - 1)) - 1;
+        if (val >= layout->bcd_limit) {
+                return limit;
+        } else if (val <= -layout->bcd_limit) {
+                return -limit;
         } else {
-                return (signed) (val / 0.02);
+                return (signed) (val / layout->bcd_step);
         }
 }
 
@@ -225,27 +225,27 @@ float average_values(float *values) {
 *       cv_pixmap containing a 2D array of cv_ts, where every
 *       four cv_ts are associated with one struct unpacked_t.
 *
-*       In/Out Expectations: Expects a struct type unpacked_pixmap. Mallocs
-*       memory for a struct cv_pixmap that the client must eventually 
-*       free. Returns this created type of cv_pixmap.  
+*       In/Out Expectations: Expects a struct type unpacked_pixmap and an 
+*       arena. Allocates the struct cv_pixmap in the arena, which frees it 
+*       when it is reset. Returns this created type of cv_pixmap.  
 */
-cv_pixmap unpacked_to_cv_pixmap(unpacked_pixmap old_unpacked_pixmap) {
+cv_pixmap unpacked_to_cv_pixmap(unpacked_pixmap old_unpacked_pixmap, 
+                                Arena40_T arena) {
         assert(old_unpacked_pixmap != NULL);
 
         int width = old_unpacked_pixmap->width * BLOCK_SIZE;
         int height = old_unpacked_pixmap->height * BLOCK_SIZE;
 
-        cv_pixmap new_cv_pixmap = malloc(sizeof(*new_cv_pixmap));
-        assert(new_cv_pixmap != NULL);
+        cv_pixmap new_cv_pixmap = Arena40_alloc(arena, 
+                                                sizeof(*new_cv_pixmap));
 
         new_cv_pixmap->width = width;
         new_cv_pixmap->height = height;
         new_cv_pixmap->methods = uarray2_methods_blocked; 
         
         cv_t dummy_cv;
-        A2Methods_UArray2 pixmap = new_cv_pixmap->methods->
-                new_with_blocksize(width, height, sizeof(*dummy_cv),
-                BLOCK_SIZE);
+        A2Methods_UArray2 pixmap = UArray2b_new_in(arena, width, height, 
+                sizeof(*dummy_cv), BLOCK_SIZE);
         new_cv_pixmap->pixels = pixmap;
 
         struct unpacked_data block_data;
@@ -297,7 +297,7 @@ void unpacked_to_cv_mapping(int i, int j, A2Methods_UArray2 array2,
 /*
 *       Description: A function that takes a type unpacked_t and gets the
 *       Y values for four instances of cv_t stored in a struct 
-*       unpacked_data.
+*       unpacked_data, for the standard layout.
 *
 *       In/Out Expectations: expects to take in an unpacked_t 
 *       element, and an unpopulated instance of struct unpacked_data. 
@@ -305,13 +305,28 @@ void unpacked_to_cv_mapping(int i, int j, A2Methods_UArray2 array2,
 */
 void calculate_y_vals(unpacked_t curr_unpacked, struct unpacked_data 
                       *block_data) {
+        calculate_y_vals_in(&standard_layout, curr_unpacked, block_data);
+}
+
+/*
+*       Description: A function that takes a type unpacked_t quantized for 
+*       a layout and gets the Y values for four instances of cv_t stored in
+*       a struct unpacked_data.
+*
+*       In/Out Expectations: expects a layout, an unpacked_t element, and an
+*       unpopulated instance of struct unpacked_data. Sets y value array in
+*       the unpacked_data struct and returns void.
+*/
+void calculate_y_vals_in(word_layout layout, unpacked_t curr_unpacked, 
+                         struct unpacked_data *block_data) {
+        assert(layout != NULL);
         assert(curr_unpacked != NULL);
         assert(block_data != NULL);
 
-        float a = ((float)(curr_unpacked->a)) / 511;
-        float b = unscaled_val(curr_unpacked->b);
-        float c = unscaled_val(curr_unpacked->c);
-        float d = unscaled_val(curr_unpacked->d);
+        float a = ((float)(curr_unpacked->a)) / layout->a_max;
+        float b = unscaled_val(curr_unpacked->b, layout);
+        float c = unscaled_val(curr_unpacked->c, layout);
+        float d = unscaled_val(curr_unpacked->d, layout);
 
         block_data->y_values[0] = a - b - c + d;
         block_data->y_values[2] = a - b + c - d;
@@ -320,27 +335,16 @@ void calculate_y_vals(unpacked_t curr_unpacked, struct unpacked_data
 }
 
 /*
-*       Description: gets a scaled down version of an signed number between 
-*       -15 and 15 as a float. 
+*       Description: gets a scaled down version of an signed number in 
+*       steps of the layout, between -15 and 15 in the standard layout, as a
+*       float. 
 *
-*       In/Out Expectations: expects to take in a type signed between -15 
-*       and 15. Returns a float between -0.3 and 0.3.
+*       In/Out Expectations: expects to take in a type signed that fits in 
+*       the b, c and d fields of the layout, and the layout. Returns a 
+*       float between -0.3 and 0.3 in the standard layout.
 */
-float unscaled_val(signed val) {
-        assert(val <= 15 && val >= -15);
-        return ((float) val) * 0.02;
+float unscaled_val(signed val, word_layout layout) {
+        signed limit = (1 << (layout->b.width - 1)) - 1;
+        assert(val <= limit && val >= -limit);
+        return ((float) val) * layout->bcd_step;
 }
-
-/*
-*       Description: Frees memory associated with a unpacked_pixmap.
-*
-*       In/Out Expectations: expects to take a unpacked_pixmap that's been
-*       mallocked on the heap. Frees memory for the pointer and for 
-*       each element in the 2D array of pixels. Returns void.
-*/
-void free_unpacked_pixmap(unpacked_pixmap pixmap) {
-        assert(pixmap != NULL);
-
-        pixmap->methods->free(&(pixmap->pixels));
-        free(pixmap);
-}
\ No newline at end of file
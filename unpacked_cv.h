@@ -19,6 +19,7 @@
 #define UNPACKED_CV_
 
 #include <a2methods.h>
+#include "arena40.h"
 #include "cv_rgb.h"
 #include "unpacked_cv.h"
 
@@ -49,13 +50,41 @@ typedef struct unpacked_pixmap {
         const struct A2Methods_T *methods;
 } *unpacked_pixmap;
 
+/* 
+ * struct unpacked_data
+ *      This is a struct to be used as a closure in the mapping functions, and
+ *      by the fused codec in word_rgb.c. It contains an unpacked_pixmap 
+ *      pixmap, 3 float arrays for the pb, pr, and y values of the 4 pixels in
+ *      each block, and a counter (used to determine when the 4 pixels have 
+ *      all been seen). The arrays hold the pixels in the order map block 
+ *      major visits them: Y1, Y3, Y2, Y4.
+ */
+struct unpacked_data {
+        unpacked_pixmap pixmap;
+        float pb_values[4];
+        float pr_values[4];
+        float y_values[4];
+        int counter;
+};
+
+
+/* the layout a block is quantized for (see word_layout.h) */
+struct word_layout;
 
 /********** COMPRESSION **********/
-unpacked_pixmap cv_to_unpacked_pixmap(cv_pixmap old_cv_pixmap);
+unpacked_pixmap cv_to_unpacked_pixmap(cv_pixmap old_cv_pixmap, 
+                                      Arena40_T arena);
+void cv_to_unpacked(struct unpacked_data *block_data, unpacked_t curr);
+void cv_to_unpacked_in(const struct word_layout *layout, 
+                       struct unpacked_data *block_data, unpacked_t curr);
 
 /********** DECOMPRESSION **********/
-cv_pixmap unpacked_to_cv_pixmap(unpacked_pixmap old_unpacked_pixmap);
-
-void free_unpacked_pixmap(unpacked_pixmap pixmap);
+cv_pixmap unpacked_to_cv_pixmap(unpacked_pixmap old_unpacked_pixmap, 
+                                Arena40_T arena);
+void calculate_y_vals(unpacked_t curr_unpacked, 
+                struct unpacked_data *block_data);
+void calculate_y_vals_in(const struct word_layout *layout, 
+                         unpacked_t curr_unpacked, 
+                         struct unpacked_data *block_data);
 
 #endif
\ No newline at end of file
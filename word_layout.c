@@ -0,0 +1,103 @@
+/******************************************************************************
+*       word_layout.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains the layouts a block can be packed into a word
+*       with, and the functions that quantize the chroma of a block the way
+*       a layout says. The standard layout is the one compress40 has always
+*       written; the fine layout gives a 16 bits, b, c and d 12 bits each,
+*       over the whole range they can take, and pb_avg and pr_avg 6 bits
+*       each, in even steps.
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "assert.h"
+#include "arith40.h"
+#include "file_word.h"
+#include "word_layout.h"
+
+/* pb and pr range from -CHROMA_LIMIT to CHROMA_LIMIT */
+#define CHROMA_LIMIT 0.5
+
+const struct word_layout standard_layout = {
+        "standard", STANDARD_BITS, FORMAT_COLUMNS,
+        { STANDARD_WIDTH_A, STANDARD_LSB_A },
+        { STANDARD_WIDTH_B, STANDARD_LSB_B },
+        { STANDARD_WIDTH_C, STANDARD_LSB_C },
+        { STANDARD_WIDTH_D, STANDARD_LSB_D },
+        { STANDARD_WIDTH_PB, STANDARD_LSB_PB },
+        { STANDARD_WIDTH_PR, STANDARD_LSB_PR },
+        511, 0.02, 0.3, true,
+        standard_pack, standard_unpack
+};
+
+const struct word_layout fine_layout = {
+        "fine", FINE_BITS, FORMAT_FINE,
+        { FINE_BITS - FINE_LSB_A, FINE_LSB_A },
+        { FINE_LSB_A - FINE_LSB_B, FINE_LSB_B },
+        { FINE_LSB_B - FINE_LSB_C, FINE_LSB_C },
+        { FINE_LSB_C - FINE_LSB_D, FINE_LSB_D },
+        { FINE_LSB_D - FINE_LSB_PB, FINE_LSB_PB },
+        { FINE_LSB_PB - FINE_LSB_PR, FINE_LSB_PR },
+        65535, 0.5 / 2047, 0.5, false,
+        fine_pack, fine_unpack
+};
+
+/*
+*       Description: A function that gives the layout of the words of a
+*       compressed file from the format in its header.
+*
+*       In/Out Expectations: Expects one of the formats in file_word.h.
+*       Returns the fine layout for FORMAT_FINE, and the standard layout
+*       for every other format.
+*/
+word_layout format_to_layout(unsigned format) {
+        return format == FORMAT_FINE ? &fine_layout : &standard_layout;
+}
+
+/*
+*       Description: A function that quantizes the average chroma of a block
+*       to the index stored in pb_avg or pr_avg.
+*
+*       In/Out Expectations: Expects a layout and a chroma, most commonly
+*       from -0.5 to 0.5. Returns an index that fits in the field.
+*/
+unsigned layout_index_of_chroma(word_layout layout, float chroma) {
+        assert(layout != NULL);
+        if (layout->arith40_chroma) {
+                return Arith40_index_of_chroma(chroma);
+        }
+
+        unsigned steps = (1u << layout->pb_avg.width) - 1;
+        if (chroma <= -CHROMA_LIMIT) {
+                return 0;
+        } else if (chroma >= CHROMA_LIMIT) {
+                return steps;
+        }
+        return (unsigned)((chroma + CHROMA_LIMIT) / (2 * CHROMA_LIMIT) *
+                          steps + 0.5);
+}
+
+/*
+*       Description: A function that gives the chroma an index stored in
+*       pb_avg or pr_avg stands for.
+*
+*       In/Out Expectations: Expects a layout and an index that fits in the
+*       field. Returns the chroma, from -0.5 to 0.5.
+*/
+float layout_chroma_of_index(word_layout layout, unsigned index) {
+        assert(layout != NULL);
+        if (layout->arith40_chroma) {
+                return Arith40_chroma_of_index(index);
+        }
+
+        unsigned steps = (1u << layout->pb_avg.width) - 1;
+        return (float)index / steps * (2 * CHROMA_LIMIT) - CHROMA_LIMIT;
+}
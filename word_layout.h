@@ -0,0 +1,138 @@
+/******************************************************************************
+*       word_layout.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*
+*       This file contains the layouts a block can be packed into a word
+*       with: where each field of the word is, how its value is quantized,
+*       and the header format of the words. The standard layout is the one
+*       in the Arith40 spec, 32 bit words; the fine layout packs each field
+*       with more bits into 64 bit words, for a higher quality at twice the
+*       size. Each layout has pack and unpack kernels generated for its
+*       fields, so every width and lsb is a constant in them.
+*
+******************************************************************************/
+
+#ifndef WORD_LAYOUT_
+#define WORD_LAYOUT_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitpack.h"
+#include "unpacked_cv.h"
+
+/*
+ * The fields of a word, from the most significant: a, b, c, d, pb_avg and
+ * pr_avg, each as wide as the distance from its lsb to the lsb of the field
+ * above it (or to the top of the word, for a)
+ */
+#define STANDARD_BITS 32
+#define STANDARD_LSB_A 23
+#define STANDARD_LSB_B 18
+#define STANDARD_LSB_C 13
+#define STANDARD_LSB_D 8
+#define STANDARD_LSB_PB 4
+#define STANDARD_LSB_PR 0
+
+#define STANDARD_WIDTH_A (STANDARD_BITS - STANDARD_LSB_A)
+#define STANDARD_WIDTH_B (STANDARD_LSB_A - STANDARD_LSB_B)
+#define STANDARD_WIDTH_C (STANDARD_LSB_B - STANDARD_LSB_C)
+#define STANDARD_WIDTH_D (STANDARD_LSB_C - STANDARD_LSB_D)
+#define STANDARD_WIDTH_PB (STANDARD_LSB_D - STANDARD_LSB_PB)
+#define STANDARD_WIDTH_PR (STANDARD_LSB_PB - STANDARD_LSB_PR)
+
+#define FINE_BITS 64
+#define FINE_LSB_A 48
+#define FINE_LSB_B 36
+#define FINE_LSB_C 24
+#define FINE_LSB_D 12
+#define FINE_LSB_PB 6
+#define FINE_LSB_PR 0
+
+/*
+ * struct word_field
+ *      A struct that holds where a field is in a word: its width and lsb.
+ */
+struct word_field {
+        unsigned width, lsb;
+};
+
+/*
+ * struct word_layout
+ *      A struct that describes a layout: its name, the bits in a word, the
+ *      header format of a file of its words, column by column, and each
+ *      field. a is quantized to a_max steps from 0 to 1; b, c and d are
+ *      quantized in steps of bcd_step and clamped to bcd_limit either way;
+ *      pb_avg and pr_avg are the indices of the Arith40 chroma table if
+ *      arith40_chroma is set, and otherwise taken in even steps from -0.5
+ *      to 0.5. pack and unpack are the kernels of the layout.
+ */
+typedef const struct word_layout {
+        const char *name;
+        unsigned word_bits;
+        unsigned format;
+        struct word_field a, b, c, d, pb_avg, pr_avg;
+        unsigned a_max;
+        double bcd_step, bcd_limit;
+        bool arith40_chroma;
+        uint64_t (*pack)(unpacked_t curr_unpacked);
+        void (*unpack)(uint64_t word, unpacked_t curr_unpacked);
+} *word_layout;
+
+extern const struct word_layout standard_layout;
+extern const struct word_layout fine_layout;
+
+word_layout format_to_layout(unsigned format);
+unsigned layout_index_of_chroma(word_layout layout, float chroma);
+float layout_chroma_of_index(word_layout layout, unsigned index);
+
+/*
+ * Generates the pack and unpack kernels of a layout, name_pack and
+ * name_unpack, from its bits and the lsb of each field, with the unchecked
+ * Bitpack functions for fixed fields
+ */
+#define LAYOUT_KERNELS(name, BITS, LSB_A, LSB_B, LSB_C, LSB_D, LSB_PB,   \
+                       LSB_PR)                                            \
+static inline uint64_t name##_pack(unpacked_t curr_unpacked)              \
+{                                                                         \
+        uint64_t word = 0;                                                \
+        word = Bitpack_newu_fixed(word, (BITS - LSB_A), LSB_A,            \
+                                  curr_unpacked->a);                      \
+        word = Bitpack_news_fixed(word, (LSB_A - LSB_B), LSB_B,           \
+                                  curr_unpacked->b);                      \
+        word = Bitpack_news_fixed(word, (LSB_B - LSB_C), LSB_C,           \
+                                  curr_unpacked->c);                      \
+        word = Bitpack_news_fixed(word, (LSB_C - LSB_D), LSB_D,           \
+                                  curr_unpacked->d);                      \
+        word = Bitpack_newu_fixed(word, (LSB_D - LSB_PB), LSB_PB,         \
+                                  curr_unpacked->pb_avg);                 \
+        word = Bitpack_newu_fixed(word, (LSB_PB - LSB_PR), LSB_PR,        \
+                                  curr_unpacked->pr_avg);                 \
+        return word;                                                      \
+}                                                                         \
+                                                                          \
+static inline void name##_unpack(uint64_t word, unpacked_t curr_unpacked) \
+{                                                                         \
+        curr_unpacked->a = Bitpack_getu_fixed(word, (BITS - LSB_A),       \
+                                              LSB_A);                     \
+        curr_unpacked->b = Bitpack_gets_fixed(word, (LSB_A - LSB_B),      \
+                                              LSB_B);                     \
+        curr_unpacked->c = Bitpack_gets_fixed(word, (LSB_B - LSB_C),      \
+                                              LSB_C);                     \
+        curr_unpacked->d = Bitpack_gets_fixed(word, (LSB_C - LSB_D),      \
+                                              LSB_D);                     \
+        curr_unpacked->pb_avg = Bitpack_getu_fixed(word,                  \
+                                        (LSB_D - LSB_PB), LSB_PB);        \
+        curr_unpacked->pr_avg = Bitpack_getu_fixed(word,                  \
+                                        (LSB_PB - LSB_PR), LSB_PR);       \
+}
+
+LAYOUT_KERNELS(standard, STANDARD_BITS, STANDARD_LSB_A, STANDARD_LSB_B,
+               STANDARD_LSB_C, STANDARD_LSB_D, STANDARD_LSB_PB,
+               STANDARD_LSB_PR)
+LAYOUT_KERNELS(fine, FINE_BITS, FINE_LSB_A, FINE_LSB_B, FINE_LSB_C,
+               FINE_LSB_D, FINE_LSB_PB, FINE_LSB_PR)
+
+#endif
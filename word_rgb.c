@@ -0,0 +1,808 @@
+/******************************************************************************
+*       word_rgb.c
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the functions necessary to convert the 2x2 blocks
+*       of an image straight to words in one pass (compression), and words
+*       straight back to 2x2 blocks of an image (decompression). Images are
+*       held in memory as rows of samples, the layout of a binary ppm, or 
+*       as rows of Pnm_rgbs when streaming. Every block goes through the 
+*       same per-element helpers as the staged pipeline, so the results are
+*       identical to the ones the staged functions build.
+*   
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <a2methods.h>
+#include "assert.h"
+#include "arith40.h"
+#include "pnm.h"
+#include "cv_rgb.h"
+#include "unpacked_cv.h"
+#include "word_unpacked.h"
+#include "word_layout.h"
+#include "file_word.h"
+#include "word_rgb.h"
+
+#define BLOCK_SIZE 2
+#define SAMPLES_PER_PIXEL 3
+#define ONE_BYTE_DENOMINATOR 255
+#define CHAR_BITS 8
+
+/* 
+ * The staged pipeline visits a block in map block major order, Y1->Y3->Y2->Y4.
+ * Averages are taken in that order so the floats round the same way.
+ */
+static const int block_major_order[BLOCK_PIXELS] = { 0, 2, 1, 3 };
+
+/* the words of a column packed or unpacked at once */
+#define FIELD_BATCH 64
+
+/* 
+ * struct field_batch
+ *      A struct that holds the fields of up to FIELD_BATCH words on the 
+ *      stack while a run of blocks is converted, and a word_fields pointing
+ *      at them that the batch functions of word_unpacked.h take.
+ */
+struct field_batch {
+        uint32_t a[FIELD_BATCH];
+        int32_t b[FIELD_BATCH], c[FIELD_BATCH], d[FIELD_BATCH];
+        uint32_t pb_avg[FIELD_BATCH], pr_avg[FIELD_BATCH];
+        struct word_fields fields;
+};
+
+/******** HELPER FUNCTIONS ********/
+static inline void open_field_batch(struct field_batch *batch);
+static inline unsigned char *block_pixels(arith40_image image, 
+                                          unsigned col, unsigned row);
+static inline unsigned run_pixel(unsigned k, int pixel, unsigned width);
+
+/******** COMPRESSION HELPER FUNCTIONS ********/
+void rgb_to_unpacked(word_layout layout, struct Pnm_rgb block[], 
+                     unsigned denominator, unpacked_t curr_unpacked);
+void image_to_unpacked(word_layout layout, arith40_image image, 
+                       unsigned col, unsigned row, unpacked_t curr_unpacked);
+void image_to_word_blocks(arith40_image image, unsigned col, unsigned row,
+                          unsigned count, bool across, uint32_t *words);
+static inline void unpacked_to_batch(unpacked_t curr_unpacked, 
+                                     struct field_batch *batch, unsigned k);
+void bytes_to_rgb(const unsigned char *bytes, size_t sample_bytes, 
+                  Pnm_rgb rgb);
+
+/******** DECOMPRESSION HELPER FUNCTIONS ********/
+void unpacked_to_rgb(word_layout layout, unpacked_t curr_unpacked, 
+                     unsigned denominator, struct Pnm_rgb block[]);
+void unpacked_to_image(word_layout layout, unpacked_t curr_unpacked, 
+                       arith40_image image, unsigned col, unsigned row);
+static inline void batch_to_unpacked(struct field_batch *batch, unsigned k,
+                                     unpacked_t curr_unpacked);
+void rgb_to_bytes(Pnm_rgb rgb, size_t sample_bytes, unsigned char *bytes);
+
+
+/*
+*       Description: Points the word_fields of a field_batch at its arrays.
+*
+*       In/Out Expectations: expects a field_batch, which may be on the 
+*       stack. Returns void.
+*/
+static inline void open_field_batch(struct field_batch *batch) {
+        batch->fields.a = batch->a;
+        batch->fields.b = batch->b;
+        batch->fields.c = batch->c;
+        batch->fields.d = batch->d;
+        batch->fields.pb_avg = batch->pb_avg;
+        batch->fields.pr_avg = batch->pr_avg;
+}
+
+/*
+*       Description: Gives the samples of the top left pixel of a 2x2 block
+*       of an image held in memory.
+*
+*       In/Out Expectations: expects a valid image and the block column and
+*       block row of a block inside it. Returns a pointer into its pixels.
+*/
+static inline unsigned char *block_pixels(arith40_image image,
+                                          unsigned col, unsigned row) {
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        return image->pixels + (size_t)row * BLOCK_SIZE * image->stride +
+               (size_t)col * BLOCK_SIZE * SAMPLES_PER_PIXEL * sample_bytes;
+}
+
+/*
+*       Description: Gives where a pixel of the k-th block of a run is in the
+*       cv_planes of the run, which hold the pixels of a rectangle width 
+*       pixels wide row by row: 2 pixels wide for a run down a block column,
+*       or 2 pixels per block for a run across a block row.
+*
+*       In/Out Expectations: expects the index of a block in the run, a 
+*       pixel of the block, from 0 (Y1) to 3 (Y4), and the width of the 
+*       rectangle. Returns the index of the pixel in the planes.
+*/
+static inline unsigned run_pixel(unsigned k, int pixel, unsigned width) {
+        unsigned x = BLOCK_SIZE * k % width;
+        unsigned y = BLOCK_SIZE * k / width * BLOCK_SIZE;
+        return (y + pixel / BLOCK_SIZE) * width + x + pixel % BLOCK_SIZE;
+}
+
+/************ COMPRESSION ************/
+
+/*
+*       Description: Generates a word (uint32_t) from a 2x2 block of Pnm_rgb
+*       pixels, converting to component video, taking the DCT, quantizing
+*       and bitpacking without storing anything but the block.
+*
+*       In/Out Expectations: expects an array of BLOCK_PIXELS Pnm_rgbs in
+*       the order Y1, Y2, Y3, Y4 and the denominator of the image they came
+*       from. Returns the packed word.
+*/
+uint32_t rgb_to_word(struct Pnm_rgb block[], unsigned denominator) {
+        assert(block != NULL);
+
+        struct unpacked_t curr_unpacked;
+        uint32_t word;
+
+        rgb_to_unpacked(&standard_layout, block, denominator, 
+                        &curr_unpacked);
+        unpacked_to_word(&word, &curr_unpacked);
+        return word;
+}
+
+/*
+*       Description: Generates the unpacked fields of a 2x2 block of Pnm_rgb
+*       pixels, converting to component video, taking the DCT and 
+*       quantizing for a layout without storing anything but the block.
+*
+*       In/Out Expectations: expects a layout, an array of BLOCK_PIXELS 
+*       Pnm_rgbs in the order Y1, Y2, Y3, Y4, the denominator of the image 
+*       they came from, and a struct unpacked_t to set. Returns void.
+*/
+void rgb_to_unpacked(word_layout layout, struct Pnm_rgb block[], 
+                     unsigned denominator, unpacked_t curr_unpacked) {
+        struct unpacked_data block_data;
+        struct cv_t curr_cv;
+
+        for (int k = 0; k < BLOCK_PIXELS; k++) {
+                rgb_to_cv(&block[block_major_order[k]], denominator, &curr_cv);
+                block_data.pb_values[k] = curr_cv.pb;
+                block_data.pr_values[k] = curr_cv.pr;
+                block_data.y_values[k] = curr_cv.y;
+        }
+
+        cv_to_unpacked_in(layout, &block_data, curr_unpacked);
+}
+
+/*
+*       Description: Converts one column of 2x2 blocks of an image held in 
+*       memory to words, from the top block to the bottom one. This is the 
+*       order the blocks of a column are written to a compressed file.
+*
+*       In/Out Expectations: expects a valid image, whose last row is not 
+*       read if its height is odd, the index of a block column, and an array
+*       with room for height / 2 words. Fills the array and returns void.
+*/
+void image_to_word_column(arith40_image image, unsigned col, 
+                          uint32_t *words) {
+        assert(image != NULL && image->pixels != NULL);
+        assert(words != NULL);
+        assert(col < image->width / BLOCK_SIZE);
+
+        image_to_word_run(image, col, 0, image->height / BLOCK_SIZE, words);
+}
+
+/*
+*       Description: Converts a horizontal band of block rows of an image 
+*       held in memory to words. Bands do not share any words, so different
+*       bands can be converted at the same time.
+*
+*       In/Out Expectations: expects a valid image, whose last row and 
+*       column are not read if they are odd, the first block row of the band
+*       and the block row just past it, and an array with room for a word 
+*       per block of the whole image. Words are stored column by column, in
+*       the order they are written to a compressed file. Returns void.
+*/
+void image_to_word_band(arith40_image image, unsigned first_row, 
+                        unsigned end_row, uint32_t *words) {
+        assert(image != NULL && image->pixels != NULL);
+        assert(words != NULL);
+        assert(first_row <= end_row && end_row <= image->height / BLOCK_SIZE);
+
+        unsigned rows = image->height / BLOCK_SIZE;
+
+        for (unsigned col = 0; col < image->width / BLOCK_SIZE; col++) {
+                uint32_t *column = words + (size_t)col * rows;
+                image_to_word_run(image, col, first_row, end_row, 
+                                  column + first_row);
+        }
+}
+
+/*
+*       Description: Converts the blocks of one column of an image held in 
+*       memory, from block row first_row to the one just before end_row, 
+*       to words, FIELD_BATCH blocks at a time.
+*
+*       In/Out Expectations: expects a valid image, the index of a block 
+*       column, the first block row and the block row just past the last,
+*       and an array with room for a word per block row. Returns void.
+*/
+void image_to_word_run(arith40_image image, unsigned col, 
+                       unsigned first_row, unsigned end_row, 
+                       uint32_t *words) {
+        for (unsigned row = first_row; row < end_row; row += FIELD_BATCH) {
+                unsigned count = end_row - row < FIELD_BATCH ? 
+                                 end_row - row : FIELD_BATCH;
+                image_to_word_blocks(image, col, row, count, false, 
+                                     words + (row - first_row));
+        }
+}
+
+/*
+*       Description: Converts a run of up to FIELD_BATCH blocks of an image 
+*       held in memory to words, going down a block column or across a 
+*       block row. The pixels of every block of the run are converted to 
+*       component video at once, then the fields of the blocks are gathered
+*       before they are all packed at once.
+*
+*       In/Out Expectations: expects a valid image, the block column and 
+*       block row of the first block of the run, the number of blocks in 
+*       it, which all lie inside the image, whether the run goes across a 
+*       block row (or down a block column), and an array with room for a 
+*       word per block. Returns void.
+*/
+void image_to_word_blocks(arith40_image image, unsigned col, unsigned row,
+                          unsigned count, bool across, uint32_t *words) {
+        assert(count <= FIELD_BATCH);
+
+        struct field_batch batch;
+        struct unpacked_t curr_unpacked;
+        struct unpacked_data block_data;
+        float y[BLOCK_PIXELS * FIELD_BATCH], pb[BLOCK_PIXELS * FIELD_BATCH];
+        float pr[BLOCK_PIXELS * FIELD_BATCH];
+        struct cv_planes planes = { y, pb, pr };
+        open_field_batch(&batch);
+
+        unsigned width = across ? BLOCK_SIZE * count : BLOCK_SIZE;
+        samples_to_cv(block_pixels(image, col, row), image->stride, width, 
+                      BLOCK_PIXELS * count / width, 
+                      image->maxval, &planes);
+        for (unsigned k = 0; k < count; k++) {
+                for (int m = 0; m < BLOCK_PIXELS; m++) {
+                        unsigned pixel = run_pixel(k, block_major_order[m],
+                                                   width);
+                        block_data.y_values[m] = y[pixel];
+                        block_data.pb_values[m] = pb[pixel];
+                        block_data.pr_values[m] = pr[pixel];
+                }
+                cv_to_unpacked_in(&standard_layout, &block_data, 
+                                  &curr_unpacked);
+                unpacked_to_batch(&curr_unpacked, &batch, k);
+        }
+        fields_to_words(&batch.fields, count, words);
+}
+
+/*
+*       Description: Stores the fields of a struct unpacked_t as the k-th 
+*       fields of a batch.
+*
+*       In/Out Expectations: expects a struct unpacked_t, a field_batch and
+*       an index less than FIELD_BATCH. Returns void.
+*/
+static inline void unpacked_to_batch(unpacked_t curr_unpacked, 
+                                     struct field_batch *batch, unsigned k) {
+        batch->a[k] = curr_unpacked->a;
+        batch->b[k] = curr_unpacked->b;
+        batch->c[k] = curr_unpacked->c;
+        batch->d[k] = curr_unpacked->d;
+        batch->pb_avg[k] = curr_unpacked->pb_avg;
+        batch->pr_avg[k] = curr_unpacked->pr_avg;
+}
+
+/*
+*       Description: Converts the 2x2 blocks of one tile of an image held in
+*       memory to words, row by row, left to right inside the tile.
+*
+*       In/Out Expectations: expects a valid image, a tile inside it, and an
+*       array with room for a word for every block of the tile. Sets the 
+*       words and returns void.
+*/
+void image_to_word_tile(arith40_image image, tile curr_tile, 
+                        uint32_t *words) {
+        assert(image != NULL && image->pixels != NULL);
+        assert(curr_tile != NULL && words != NULL);
+
+        for (unsigned row = curr_tile->first_row; row < curr_tile->end_row;
+             row++) {
+                for (unsigned col = curr_tile->first_col; 
+                     col < curr_tile->end_col; col += FIELD_BATCH) {
+                        unsigned count = curr_tile->end_col - col < 
+                                         FIELD_BATCH ? 
+                                         curr_tile->end_col - col : 
+                                         FIELD_BATCH;
+                        image_to_word_blocks(image, col, row, count, true,
+                                             words);
+                        words += count;
+                }
+        }
+}
+
+/*
+*       Description: Converts one column of 2x2 blocks of an image held in 
+*       memory to the words of a layout, from the top block to the bottom 
+*       one, each packed with the kernel of the layout.
+*
+*       In/Out Expectations: expects a layout, a valid image, whose last row
+*       is not read if its height is odd, the index of a block column, and 
+*       an array with room for height / 2 words, each in the low word_bits
+*       bits of a uint64_t. Fills the array and returns void.
+*/
+void image_to_layout_column(word_layout layout, arith40_image image, 
+                            unsigned col, uint64_t *words) {
+        assert(layout != NULL);
+        assert(image != NULL && image->pixels != NULL);
+        assert(words != NULL);
+        assert(col < image->width / BLOCK_SIZE);
+
+        struct unpacked_t curr_unpacked;
+
+        for (unsigned row = 0; row < image->height / BLOCK_SIZE; row++) {
+                image_to_unpacked(layout, image, col, row, &curr_unpacked);
+                words[row] = layout->pack(&curr_unpacked);
+        }
+}
+
+/*
+*       Description: Generates the unpacked fields of one 2x2 block of an 
+*       image held in memory, reading its 4 pixels straight from the rows of
+*       samples, quantized for a layout.
+*
+*       In/Out Expectations: expects a layout, a valid image, the block 
+*       column and block row of a block inside it, and a struct unpacked_t 
+*       to set. Returns void.
+*/
+void image_to_unpacked(word_layout layout, arith40_image image, 
+                       unsigned col, unsigned row, unpacked_t curr_unpacked) {
+        struct Pnm_rgb block[BLOCK_PIXELS];
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        size_t pixel_bytes = SAMPLES_PER_PIXEL * sample_bytes;
+        const unsigned char *top = image->pixels + 
+                (size_t)row * BLOCK_SIZE * image->stride + 
+                (size_t)col * BLOCK_SIZE * pixel_bytes;
+        const unsigned char *bottom = top + image->stride;
+
+        bytes_to_rgb(top, sample_bytes, &block[0]);
+        bytes_to_rgb(top + pixel_bytes, sample_bytes, &block[1]);
+        bytes_to_rgb(bottom, sample_bytes, &block[2]);
+        bytes_to_rgb(bottom + pixel_bytes, sample_bytes, &block[3]);
+        rgb_to_unpacked(layout, block, image->maxval, curr_unpacked);
+}
+
+/*
+*       Description: A function that reads the three samples of a pixel held
+*       in memory, each one byte or two bytes, most significant first.
+*
+*       In/Out Expectations: expects the bytes of the pixel, the number of
+*       bytes in a sample and a Pnm_rgb to set. Returns void.
+*/
+void bytes_to_rgb(const unsigned char *bytes, size_t sample_bytes, 
+                  Pnm_rgb rgb) {
+        if (sample_bytes == 1) {
+                rgb->red = bytes[0];
+                rgb->green = bytes[1];
+                rgb->blue = bytes[2];
+        } else {
+                rgb->red = (bytes[0] << CHAR_BITS) | bytes[1];
+                rgb->green = (bytes[2] << CHAR_BITS) | bytes[3];
+                rgb->blue = (bytes[4] << CHAR_BITS) | bytes[5];
+        }
+}
+
+/*
+*       Description: Converts one row of 2x2 blocks, given as the two rows of
+*       pixels it covers, to words from the leftmost block to the rightmost
+*       one. This is the order the blocks of a row are written to a file of
+*       the row by row format.
+*
+*       In/Out Expectations: expects the top and bottom rows of pixels of a
+*       block row, with at least 2 * columns pixels each, their denominator,
+*       and an array with room for columns words. Fills the array and 
+*       returns void.
+*/
+void rgb_to_word_row(struct Pnm_rgb *top, struct Pnm_rgb *bottom, 
+                     unsigned columns, unsigned denominator, uint32_t *words) {
+        assert(top != NULL && bottom != NULL);
+        assert(words != NULL);
+
+        struct Pnm_rgb block[BLOCK_PIXELS];
+
+        for (unsigned col = 0; col < columns; col++) {
+                unsigned i = col * BLOCK_SIZE;
+                block[0] = top[i];
+                block[1] = top[i + 1];
+                block[2] = bottom[i];
+                block[3] = bottom[i + 1];
+                words[col] = rgb_to_word(block, denominator);
+        }
+}
+
+/************ DECOMPRESSION ************/
+
+/*
+*       Description: Generates a 2x2 block of Pnm_rgb pixels from a word 
+*       (uint32_t), unpacking it, taking the inverse DCT and converting back
+*       from component video without storing anything but the block.
+*
+*       In/Out Expectations: expects a word, the denominator to scale the 
+*       pixels to, and an array of BLOCK_PIXELS Pnm_rgbs, which are set in 
+*       the order Y1, Y2, Y3, Y4. Returns void.
+*/
+void word_to_rgb(uint32_t word, unsigned denominator, struct Pnm_rgb block[]) {
+        assert(block != NULL);
+
+        struct unpacked_t curr_unpacked;
+
+        word_to_unpacked(&curr_unpacked, &word);
+        unpacked_to_rgb(&standard_layout, &curr_unpacked, denominator, block);
+}
+
+/*
+*       Description: Generates a 2x2 block of Pnm_rgb pixels from the 
+*       unpacked fields of a word of a layout, taking the inverse DCT and 
+*       converting back from component video without storing anything but 
+*       the block.
+*
+*       In/Out Expectations: expects a layout, a struct unpacked_t, the 
+*       denominator to scale the pixels to, and an array of BLOCK_PIXELS 
+*       Pnm_rgbs, which are set in the order Y1, Y2, Y3, Y4. Returns void.
+*/
+void unpacked_to_rgb(word_layout layout, unpacked_t curr_unpacked, 
+                     unsigned denominator, struct Pnm_rgb block[]) {
+        struct unpacked_data block_data;
+        struct cv_t curr_cv;
+
+        calculate_y_vals_in(layout, curr_unpacked, &block_data);
+        curr_cv.pb = layout_chroma_of_index(layout, curr_unpacked->pb_avg);
+        curr_cv.pr = layout_chroma_of_index(layout, curr_unpacked->pr_avg);
+
+        for (int k = 0; k < BLOCK_PIXELS; k++) {
+                curr_cv.y = block_data.y_values[k];
+                cv_to_rgb(&curr_cv, denominator, 
+                          &block[block_major_order[k]]);
+        }
+}
+
+/*
+*       Description: Converts the words of one column of 2x2 blocks back to 
+*       pixels of an image held in memory, from the top block to the bottom
+*       one. The pixels of up to FIELD_BATCH blocks are converted from 
+*       component video at once.
+*
+*       In/Out Expectations: expects a valid image with an even width and 
+*       height, the index of a block column, and an array of height / 2 
+*       words read from that column. Sets the pixels of the column and 
+*       returns void.
+*/
+void word_column_to_image(uint32_t *words, arith40_image image, 
+                          unsigned col) {
+        assert(image != NULL && image->pixels != NULL);
+        assert(words != NULL);
+        assert(col < image->width / BLOCK_SIZE);
+
+        struct field_batch batch;
+        struct unpacked_t curr_unpacked;
+        struct unpacked_data block_data;
+        float y[BLOCK_PIXELS * FIELD_BATCH], pb[BLOCK_PIXELS * FIELD_BATCH];
+        float pr[BLOCK_PIXELS * FIELD_BATCH];
+        struct cv_planes planes = { y, pb, pr };
+        open_field_batch(&batch);
+
+        unsigned rows = image->height / BLOCK_SIZE;
+        for (unsigned row = 0; row < rows; row += FIELD_BATCH) {
+                unsigned count = rows - row < FIELD_BATCH ? rows - row : 
+                                                            FIELD_BATCH;
+                words_to_fields(words + row, count, &batch.fields);
+                for (unsigned k = 0; k < count; k++) {
+                        batch_to_unpacked(&batch, k, &curr_unpacked);
+                        calculate_y_vals_in(&standard_layout, &curr_unpacked,
+                                            &block_data);
+                        float block_pb = layout_chroma_of_index(
+                                &standard_layout, curr_unpacked.pb_avg);
+                        float block_pr = layout_chroma_of_index(
+                                &standard_layout, curr_unpacked.pr_avg);
+                        for (int m = 0; m < BLOCK_PIXELS; m++) {
+                                unsigned pixel = BLOCK_PIXELS * k + 
+                                                 block_major_order[m];
+                                y[pixel] = block_data.y_values[m];
+                                pb[pixel] = block_pb;
+                                pr[pixel] = block_pr;
+                        }
+                }
+                cv_to_samples(&planes, BLOCK_SIZE, BLOCK_SIZE * count, 
+                              image->maxval, block_pixels(image, col, row),
+                              image->stride);
+        }
+}
+
+/*
+*       Description: Sets a struct unpacked_t to the k-th fields of a batch.
+*
+*       In/Out Expectations: expects a field_batch, an index less than 
+*       FIELD_BATCH, and a struct unpacked_t to set. Returns void.
+*/
+static inline void batch_to_unpacked(struct field_batch *batch, unsigned k,
+                                     unpacked_t curr_unpacked) {
+        curr_unpacked->a = batch->a[k];
+        curr_unpacked->b = batch->b[k];
+        curr_unpacked->c = batch->c[k];
+        curr_unpacked->d = batch->d[k];
+        curr_unpacked->pb_avg = batch->pb_avg[k];
+        curr_unpacked->pr_avg = batch->pr_avg[k];
+}
+
+/*
+*       Description: Converts the words of one tile, held in memory as the 
+*       chars they are stored as, back to the pixels of the tile, row by 
+*       row, left to right inside the tile. Given a window, only the blocks
+*       of the tile inside the window are converted, and the image holds 
+*       just the window, its first block being the window's first block.
+*
+*       In/Out Expectations: expects the chars of every word of the tile, a
+*       tile, a valid image, and a window (whose offset, length and crc are
+*       not used), or NULL if the image is the whole image. Sets the pixels
+*       of the tile inside the window and returns void.
+*/
+void word_tile_to_image(const unsigned char *bytes, tile curr_tile, 
+                        arith40_image image, tile window) {
+        assert(image != NULL && image->pixels != NULL);
+        assert(curr_tile != NULL && bytes != NULL);
+
+        struct tile blocks = *curr_tile;
+        unsigned origin_col = 0, origin_row = 0;
+        if (window != NULL) {
+                origin_col = window->first_col;
+                origin_row = window->first_row;
+                if (blocks.first_col < window->first_col) {
+                        blocks.first_col = window->first_col;
+                }
+                if (blocks.first_row < window->first_row) {
+                        blocks.first_row = window->first_row;
+                }
+                if (blocks.end_col > window->end_col) {
+                        blocks.end_col = window->end_col;
+                }
+                if (blocks.end_row > window->end_row) {
+                        blocks.end_row = window->end_row;
+                }
+        }
+
+        size_t tile_width = curr_tile->end_col - curr_tile->first_col;
+        for (unsigned row = blocks.first_row; row < blocks.end_row; row++) {
+                const unsigned char *word = bytes + sizeof(uint32_t) * 
+                        ((row - curr_tile->first_row) * tile_width + 
+                         (blocks.first_col - curr_tile->first_col));
+                for (unsigned col = blocks.first_col; col < blocks.end_col;
+                     col++) {
+                        word_to_image(bytes_to_word(word), image, 
+                                      col - origin_col, row - origin_row);
+                        word += sizeof(uint32_t);
+                }
+        }
+}
+
+/*
+*       Description: Stores the 2x2 block of pixels of a word in an image 
+*       held in memory, quantized straight to the maxval of the image.
+*
+*       In/Out Expectations: expects a word, a valid image, and the block 
+*       column and block row of a block inside it. Returns void.
+*/
+void word_to_image(uint32_t word, arith40_image image, unsigned col, 
+                   unsigned row) {
+        struct unpacked_t curr_unpacked;
+
+        word_to_unpacked(&curr_unpacked, &word);
+        unpacked_to_image(&standard_layout, &curr_unpacked, image, col, row);
+}
+
+/*
+*       Description: Converts the words of a layout of one column of 2x2 
+*       blocks back to pixels of an image held in memory, from the top 
+*       block to the bottom one, each unpacked with the kernel of the 
+*       layout.
+*
+*       In/Out Expectations: expects a layout, an array of height / 2 words
+*       read from that column, a valid image with an even width and height,
+*       and the index of a block column. Sets the pixels of the column and 
+*       returns void.
+*/
+void layout_column_to_image(word_layout layout, uint64_t *words, 
+                            arith40_image image, unsigned col) {
+        assert(layout != NULL);
+        assert(image != NULL && image->pixels != NULL);
+        assert(words != NULL);
+        assert(col < image->width / BLOCK_SIZE);
+
+        for (unsigned row = 0; row < image->height / BLOCK_SIZE; row++) {
+                layout_word_to_image(layout, words[row], image, col, row);
+        }
+}
+
+/*
+*       Description: Stores the 2x2 block of pixels of a word of a layout in
+*       an image held in memory, quantized straight to the maxval of the 
+*       image.
+*
+*       In/Out Expectations: expects a layout, a word in the low word_bits 
+*       bits of a uint64_t, a valid image, and the block column and block 
+*       row of a block inside it. Returns void.
+*/
+void layout_word_to_image(word_layout layout, uint64_t word, 
+                          arith40_image image, unsigned col, unsigned row) {
+        struct unpacked_t curr_unpacked;
+
+        layout->unpack(word, &curr_unpacked);
+        unpacked_to_image(layout, &curr_unpacked, image, col, row);
+}
+
+/*
+*       Description: Stores the 2x2 block of pixels of the unpacked fields 
+*       of a word of a layout in an image held in memory, quantized straight
+*       to the maxval of the image.
+*
+*       In/Out Expectations: expects a layout, a struct unpacked_t, a valid 
+*       image, and the block column and block row of a block inside it. 
+*       Returns void.
+*/
+void unpacked_to_image(word_layout layout, unpacked_t curr_unpacked, 
+                       arith40_image image, unsigned col, unsigned row) {
+        struct Pnm_rgb block[BLOCK_PIXELS];
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+        size_t pixel_bytes = SAMPLES_PER_PIXEL * sample_bytes;
+        unsigned char *top = image->pixels + 
+                (size_t)row * BLOCK_SIZE * image->stride + 
+                (size_t)col * BLOCK_SIZE * pixel_bytes;
+        unsigned char *bottom = top + image->stride;
+
+        unpacked_to_rgb(layout, curr_unpacked, image->maxval, block);
+        rgb_to_bytes(&block[0], sample_bytes, top);
+        rgb_to_bytes(&block[1], sample_bytes, top + pixel_bytes);
+        rgb_to_bytes(&block[2], sample_bytes, bottom);
+        rgb_to_bytes(&block[3], sample_bytes, bottom + pixel_bytes);
+}
+
+/*
+*       Description: Stores the pixel of a thumbnail a word stands for: the 
+*       mean brightness a and the average chroma of its block, converted 
+*       back from component video without taking the inverse DCT. 
+*
+*       In/Out Expectations: expects a word, a valid image half as wide and
+*       half as tall as the one the word came from, and the block column and
+*       block row of the word, which is the pixel it sets. Returns void.
+*/
+void word_to_thumbnail(uint32_t word, arith40_image image, unsigned col, 
+                       unsigned row) {
+        struct unpacked_t curr_unpacked;
+        struct cv_t curr_cv;
+        struct Pnm_rgb rgb;
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+
+        word_to_unpacked_averages(&curr_unpacked, &word);
+        curr_cv.y = ((float)(curr_unpacked.a)) / standard_layout.a_max;
+        curr_cv.pb = Arith40_chroma_of_index(curr_unpacked.pb_avg);
+        curr_cv.pr = Arith40_chroma_of_index(curr_unpacked.pr_avg);
+        cv_to_rgb(&curr_cv, image->maxval, &rgb);
+
+        rgb_to_bytes(&rgb, sample_bytes, image->pixels + 
+                     (size_t)row * image->stride + 
+                     (size_t)col * SAMPLES_PER_PIXEL * sample_bytes);
+}
+
+/*
+*       Description: Stores the pixel of a thumbnail a word of a layout 
+*       stands for, the way word_to_thumbnail does for a word of the 
+*       standard layout.
+*
+*       In/Out Expectations: expects a layout, a word in the low word_bits 
+*       bits of a uint64_t, a valid image half as wide and half as tall as 
+*       the one the word came from, and the block column and block row of 
+*       the word, which is the pixel it sets. Returns void.
+*/
+void layout_word_to_thumbnail(word_layout layout, uint64_t word, 
+                              arith40_image image, unsigned col, 
+                              unsigned row) {
+        assert(layout != NULL);
+
+        struct unpacked_t curr_unpacked;
+        struct cv_t curr_cv;
+        struct Pnm_rgb rgb;
+        size_t sample_bytes = image->maxval > ONE_BYTE_DENOMINATOR ? 2 : 1;
+
+        layout->unpack(word, &curr_unpacked);
+        curr_cv.y = ((float)(curr_unpacked.a)) / layout->a_max;
+        curr_cv.pb = layout_chroma_of_index(layout, curr_unpacked.pb_avg);
+        curr_cv.pr = layout_chroma_of_index(layout, curr_unpacked.pr_avg);
+        cv_to_rgb(&curr_cv, image->maxval, &rgb);
+
+        rgb_to_bytes(&rgb, sample_bytes, image->pixels + 
+                     (size_t)row * image->stride + 
+                     (size_t)col * SAMPLES_PER_PIXEL * sample_bytes);
+}
+
+/*
+*       Description: Converts the words of one tile, held in memory as the 
+*       chars they are stored as, to the pixels of a thumbnail, one pixel
+*       per word (see word_to_thumbnail).
+*
+*       In/Out Expectations: expects the chars of every word of the tile, a
+*       tile, and a valid image with a pixel for every block of the image 
+*       the tile came from. Returns void.
+*/
+void word_tile_to_thumbnail(const unsigned char *bytes, tile curr_tile, 
+                            arith40_image image) {
+        assert(image != NULL && image->pixels != NULL);
+        assert(curr_tile != NULL && bytes != NULL);
+
+        for (unsigned row = curr_tile->first_row; row < curr_tile->end_row; 
+             row++) {
+                for (unsigned col = curr_tile->first_col; 
+                     col < curr_tile->end_col; col++) {
+                        word_to_thumbnail(bytes_to_word(bytes), image, col, 
+                                          row);
+                        bytes += sizeof(uint32_t);
+                }
+        }
+}
+
+/*
+*       Description: A function that stores the three samples of a pixel in
+*       memory, each as one byte or as two bytes, most significant first.
+*
+*       In/Out Expectations: expects a Pnm_rgb whose samples fit in the 
+*       number of bytes in a sample, that number, and the bytes of the 
+*       pixel. Returns void.
+*/
+void rgb_to_bytes(Pnm_rgb rgb, size_t sample_bytes, unsigned char *bytes) {
+        if (sample_bytes == 1) {
+                bytes[0] = rgb->red;
+                bytes[1] = rgb->green;
+                bytes[2] = rgb->blue;
+        } else {
+                bytes[0] = rgb->red >> CHAR_BITS;
+                bytes[1] = rgb->red;
+                bytes[2] = rgb->green >> CHAR_BITS;
+                bytes[3] = rgb->green;
+                bytes[4] = rgb->blue >> CHAR_BITS;
+                bytes[5] = rgb->blue;
+        }
+}
+
+/*
+*       Description: Converts the words of one row of 2x2 blocks back to the
+*       two rows of pixels they cover, from the leftmost block to the 
+*       rightmost one.
+*
+*       In/Out Expectations: expects an array of columns words read from a 
+*       block row, the denominator to scale the pixels to, and top and 
+*       bottom arrays with room for 2 * columns Pnm_rgbs each, which are 
+*       set. Returns void.
+*/
+void word_row_to_rgb(uint32_t *words, unsigned columns, unsigned denominator,
+                     struct Pnm_rgb *top, struct Pnm_rgb *bottom) {
+        assert(words != NULL);
+        assert(top != NULL && bottom != NULL);
+
+        struct Pnm_rgb block[BLOCK_PIXELS];
+
+        for (unsigned col = 0; col < columns; col++) {
+                unsigned i = col * BLOCK_SIZE;
+                word_to_rgb(words[col], denominator, block);
+                top[i] = block[0];
+                top[i + 1] = block[1];
+                bottom[i] = block[2];
+                bottom[i + 1] = block[3];
+        }
+}
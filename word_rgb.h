@@ -0,0 +1,70 @@
+/******************************************************************************
+*       word_rgb.h
+*       By: Kalyn (kmuhle01) and Hannah (hshade01)
+*       10/18/2026
+*
+*       Comp40 Project 4: arith
+*   
+*       This file contains the function declarations for the fused codec, 
+*       which converts each 2x2 block of pixels straight to a word and each
+*       word straight back to a 2x2 block of pixels, 
+*       without building a cv_pixmap, unpacked_pixmap or word_pixmap. The 
+*       staged functions in cv_rgb.h, unpacked_cv.h and word_unpacked.h are
+*       kept as the reference path the fused codec is checked against.
+*   
+******************************************************************************/
+
+#ifndef WORD_RGB_
+#define WORD_RGB_
+
+#include <stdint.h>
+#include "pnm.h"
+#include "buffer40.h"
+#include "file_tile.h"
+#include "word_layout.h"
+
+/* 
+ * A block holds its 4 pixels in the order Y1 (top left), Y2 (top right),
+ * Y3 (bottom left), Y4 (bottom right)
+ */
+#define BLOCK_PIXELS 4
+
+/********** COMPRESSION **********/
+uint32_t rgb_to_word(struct Pnm_rgb block[], unsigned denominator);
+void image_to_word_column(arith40_image image, unsigned col, 
+                          uint32_t *words);
+void image_to_word_band(arith40_image image, unsigned first_row, 
+                        unsigned end_row, uint32_t *words);
+void image_to_word_run(arith40_image image, unsigned col, 
+                       unsigned first_row, unsigned end_row, 
+                       uint32_t *words);
+void image_to_word_tile(arith40_image image, tile curr_tile, 
+                        uint32_t *words);
+void rgb_to_word_row(struct Pnm_rgb *top, struct Pnm_rgb *bottom, 
+                     unsigned columns, unsigned denominator, uint32_t *words);
+void image_to_layout_column(word_layout layout, arith40_image image, 
+                            unsigned col, uint64_t *words);
+
+/********** DECOMPRESSION **********/
+void word_to_rgb(uint32_t word, unsigned denominator, struct Pnm_rgb block[]);
+void word_column_to_image(uint32_t *words, arith40_image image, 
+                          unsigned col);
+void word_to_image(uint32_t word, arith40_image image, unsigned col, 
+                   unsigned row);
+void word_tile_to_image(const unsigned char *bytes, tile curr_tile, 
+                        arith40_image image, tile window);
+void word_to_thumbnail(uint32_t word, arith40_image image, unsigned col, 
+                       unsigned row);
+void word_tile_to_thumbnail(const unsigned char *bytes, tile curr_tile, 
+                            arith40_image image);
+void word_row_to_rgb(uint32_t *words, unsigned columns, unsigned denominator,
+                     struct Pnm_rgb *top, struct Pnm_rgb *bottom);
+void layout_column_to_image(word_layout layout, uint64_t *words, 
+                            arith40_image image, unsigned col);
+void layout_word_to_image(word_layout layout, uint64_t word, 
+                          arith40_image image, unsigned col, unsigned row);
+void layout_word_to_thumbnail(word_layout layout, uint64_t word, 
+                              arith40_image image, unsigned col, 
+                              unsigned row);
+
+#endif
@@ -7,7 +7,13 @@
 *   
 *       This file contains the functions necessary to convert an image in the
 *       form of an unpacked_pixmap to a word_pixmap (compression), and back 
-*       from a word_pixmap to an unpacked_pixmap (decompression). 
+*       from a word_pixmap to an unpacked_pixmap (decompression). The
+*       fields are packed and unpacked with the kernels of the standard 
+*       layout (see word_layout.h), whose widths and lsbs are constants. 
+*       Runs of words can also be packed from, or unpacked to, a structure 
+*       of arrays of their fields, 8 words per instruction with AVX2 or 4 
+*       with SSE2 when the CPU running the codec has them, which is checked
+*       once, on first use.
 *   
 ******************************************************************************/
 
@@ -15,33 +21,75 @@
 #include <math.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
 #include <a2methods.h>
 #include "assert.h"
 #include "a2blocked.h"
 #include "uarray2b.h"
 #include "unpacked_cv.h"
 #include "bitpack.h"
+#include "word_layout.h"
 #include "word_unpacked.h"
 
 
 #define COMPRESSED_BLOCK_SIZE 1
-#define MAX_BITS 32
-#define LSB_A 23
-#define LSB_B 18
-#define LSB_C 13
-#define LSB_D 8
-#define LSB_PB 4
-#define LSB_PR 0
+#define MAX_BITS STANDARD_BITS
+#define LSB_A STANDARD_LSB_A
+#define LSB_B STANDARD_LSB_B
+#define LSB_C STANDARD_LSB_C
+#define LSB_D STANDARD_LSB_D
+#define LSB_PB STANDARD_LSB_PB
+#define LSB_PR STANDARD_LSB_PR
+
+/* the x86 vector instructions the batch functions can use */
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FIELDS_SIMD 1
+#else
+#define FIELDS_SIMD 0
+#endif
+
+/* 
+ * the batch functions for the CPU running the codec, chosen by 
+ * choose_field_functions the first time one of them is called
+ */
+static void (*pack_fields)(word_fields fields, unsigned count, 
+                           uint32_t *words);
+static void (*unpack_words)(const uint32_t *words, unsigned count, 
+                            word_fields fields);
+static pthread_once_t field_functions_once = PTHREAD_ONCE_INIT;
+
+/******** HELPER FUNCTIONS ********/
+void choose_field_functions(void);
+void fields_to_words_portable(word_fields fields, unsigned count, 
+                              uint32_t *words);
+void words_to_fields_portable(const uint32_t *words, unsigned count, 
+                              word_fields fields);
 
 /******** COMPRESSION HELPER FUNCTIONS ********/
 void unpacked_to_word_mapping(int i, int j, A2Methods_UArray2 array2, 
                 A2Methods_Object *word, void *pixmap);
-void unpacked_to_word(uint32_t* curr_word, unpacked_t curr_unpacked);
+void fields_to_words_scalar(word_fields fields, unsigned first, 
+                            unsigned count, uint32_t *words);
+#if FIELDS_SIMD
+void fields_to_words_sse2(word_fields fields, unsigned count, 
+                          uint32_t *words);
+void fields_to_words_avx2(word_fields fields, unsigned count, 
+                          uint32_t *words);
+#endif
 
 /******** DECOMPRESSION HELPER FUNCTIONS ********/
 void word_to_unpacked_mapping(int i, int j, A2Methods_UArray2 array2, 
                 A2Methods_Object *unpacked, void *pixmap);
-void word_to_unpacked(unpacked_t curr_unpacked, uint32_t* curr_word);
+void words_to_fields_scalar(const uint32_t *words, unsigned first, 
+                            unsigned count, word_fields fields);
+#if FIELDS_SIMD
+void words_to_fields_sse2(const uint32_t *words, unsigned count, 
+                          word_fields fields);
+void words_to_fields_avx2(const uint32_t *words, unsigned count, 
+                          word_fields fields);
+#endif
 
 
 /************ COMPRESSION ************/
@@ -52,27 +100,27 @@ void word_to_unpacked(unpacked_t curr_unpacked, uint32_t* curr_word);
 *       word_pixmap containing a 2D array of unint32_ts. 
 *
 *   
-*       In/Out Expectations: Expects a struct type unpacked_pixmap. Mallocs
-*       memory for a struct word_pixmap that the client must eventually free.
-*       Returns this created type of word_pixmap.  
+*       In/Out Expectations: Expects a struct type unpacked_pixmap and an 
+*       arena. Allocates the struct word_pixmap in the arena, which frees it 
+*       when it is reset. Returns this created type of word_pixmap.  
 */
-word_pixmap unpacked_to_word_pixmap(unpacked_pixmap old_unpacked_pixmap) {
+word_pixmap unpacked_to_word_pixmap(unpacked_pixmap old_unpacked_pixmap,
+                                    Arena40_T arena) {
         assert(old_unpacked_pixmap != NULL);
 
         int width = old_unpacked_pixmap->width;
         int height = old_unpacked_pixmap->height;
 
-        word_pixmap new_word_pixmap = malloc(sizeof(*new_word_pixmap));
-        assert(new_word_pixmap != NULL);
+        word_pixmap new_word_pixmap = Arena40_alloc(arena, 
+                                                    sizeof(*new_word_pixmap));
 
         new_word_pixmap->width = width;
         new_word_pixmap->height = height;
         new_word_pixmap->methods = uarray2_methods_blocked;
         
         uint32_t dummy_uint32;
-        A2Methods_UArray2 pixmap = new_word_pixmap->methods->
-                new_with_blocksize(width, height, sizeof(dummy_uint32),    
-                COMPRESSED_BLOCK_SIZE);
+        A2Methods_UArray2 pixmap = UArray2b_new_in(arena, width, height, 
+                sizeof(dummy_uint32), COMPRESSED_BLOCK_SIZE);
         new_word_pixmap->pixels = pixmap;
         
         new_word_pixmap->methods->map_block_major(new_word_pixmap->pixels, 
@@ -117,21 +165,143 @@ void unpacked_to_word(uint32_t* curr_word, unpacked_t curr_unpacked) {
         assert(curr_unpacked != NULL);
         assert(curr_word != NULL);
 
-        *curr_word = 0;
-        *curr_word = Bitpack_newu(*curr_word, (MAX_BITS - LSB_A), LSB_A,
-                curr_unpacked->a);
-        *curr_word = Bitpack_news(*curr_word, (LSB_A - LSB_B), LSB_B,
-                curr_unpacked->b);
-        *curr_word = Bitpack_news(*curr_word, (LSB_B - LSB_C), LSB_C,
-                curr_unpacked->c);
-        *curr_word = Bitpack_news(*curr_word, (LSB_C - LSB_D), LSB_D,
-                curr_unpacked->d);
-        *curr_word = Bitpack_newu(*curr_word, (LSB_D - LSB_PB), LSB_PB,
-                curr_unpacked->pb_avg);
-        *curr_word = Bitpack_newu(*curr_word, (LSB_PB - LSB_PR), LSB_PR,
-                curr_unpacked->pr_avg);
+        *curr_word = standard_pack(curr_unpacked);
 }
 
+/*
+*       Description: Packs count words from the fields of each, held as a 
+*       structure of arrays, with the widest vector instructions the CPU 
+*       has. The words are the ones unpacked_to_word packs.
+*
+*       In/Out Expectations: expects a word_fields whose arrays each hold 
+*       count fields that fit in their widths, and an array with room for 
+*       count words, which are set. Returns void.
+*/
+void fields_to_words(word_fields fields, unsigned count, uint32_t *words) {
+        assert(fields != NULL);
+        assert(words != NULL || count == 0);
+
+        pthread_once(&field_functions_once, choose_field_functions);
+        pack_fields(fields, count, words);
+}
+
+/*
+*       Description: Packs the words [first, count) from their fields one 
+*       at a time: the whole run on a CPU without vector instructions, or
+*       the words left over after the last full vector.
+*
+*       In/Out Expectations: expects a word_fields whose arrays each hold 
+*       count fields that fit in their widths, the first word to pack, and 
+*       an array with room for count words. Returns void.
+*/
+void fields_to_words_scalar(word_fields fields, unsigned first, 
+                            unsigned count, uint32_t *words) {
+        for (unsigned k = first; k < count; k++) {
+                uint64_t word = 0;
+                word = Bitpack_newu_fixed(word, (MAX_BITS - LSB_A), LSB_A,
+                                          fields->a[k]);
+                word = Bitpack_news_fixed(word, (LSB_A - LSB_B), LSB_B,
+                                          fields->b[k]);
+                word = Bitpack_news_fixed(word, (LSB_B - LSB_C), LSB_C,
+                                          fields->c[k]);
+                word = Bitpack_news_fixed(word, (LSB_C - LSB_D), LSB_D,
+                                          fields->d[k]);
+                word = Bitpack_newu_fixed(word, (LSB_D - LSB_PB), LSB_PB,
+                                          fields->pb_avg[k]);
+                word = Bitpack_newu_fixed(word, (LSB_PB - LSB_PR), LSB_PR,
+                                          fields->pr_avg[k]);
+                words[k] = word;
+        }
+}
+
+#if FIELDS_SIMD
+/*
+*       Description: Packs words from their fields 4 at a time with SSE2: 
+*       each field is masked to its width and shifted to its lsb, and the 
+*       fields are ORed together. The words left over are packed one at a 
+*       time.
+*
+*       In/Out Expectations: like fields_to_words, on a CPU with SSE2. 
+*       Returns void.
+*/
+__attribute__((target("sse2")))
+void fields_to_words_sse2(word_fields fields, unsigned count, 
+                          uint32_t *words) {
+        const __m128i signed_mask = _mm_set1_epi32((1 << (LSB_A - LSB_B)) - 1);
+        const __m128i chroma_mask = _mm_set1_epi32((1 << (LSB_PB - LSB_PR)) -
+                                                   1);
+        unsigned k = 0;
+        for (; k + 4 <= count; k += 4) {
+                __m128i a = _mm_loadu_si128((const __m128i *)(fields->a + k));
+                __m128i b = _mm_loadu_si128((const __m128i *)(fields->b + k));
+                __m128i c = _mm_loadu_si128((const __m128i *)(fields->c + k));
+                __m128i d = _mm_loadu_si128((const __m128i *)(fields->d + k));
+                __m128i pb = _mm_loadu_si128((const __m128i *)
+                                             (fields->pb_avg + k));
+                __m128i pr = _mm_loadu_si128((const __m128i *)
+                                             (fields->pr_avg + k));
+
+                __m128i word = _mm_slli_epi32(a, LSB_A);
+                word = _mm_or_si128(word, _mm_slli_epi32(_mm_and_si128(b, 
+                                        signed_mask), LSB_B));
+                word = _mm_or_si128(word, _mm_slli_epi32(_mm_and_si128(c, 
+                                        signed_mask), LSB_C));
+                word = _mm_or_si128(word, _mm_slli_epi32(_mm_and_si128(d, 
+                                        signed_mask), LSB_D));
+                word = _mm_or_si128(word, _mm_slli_epi32(_mm_and_si128(pb, 
+                                        chroma_mask), LSB_PB));
+                word = _mm_or_si128(word, _mm_and_si128(pr, chroma_mask));
+                _mm_storeu_si128((__m128i *)(words + k), word);
+        }
+        fields_to_words_scalar(fields, k, count, words);
+}
+
+/*
+*       Description: Packs words from their fields 8 at a time with AVX2, 
+*       the way fields_to_words_sse2 packs 4.
+*
+*       In/Out Expectations: like fields_to_words, on a CPU with AVX2. 
+*       Returns void.
+*/
+__attribute__((target("avx2")))
+void fields_to_words_avx2(word_fields fields, unsigned count, 
+                          uint32_t *words) {
+        const __m256i signed_mask = _mm256_set1_epi32((1 << (LSB_A - LSB_B)) -
+                                                      1);
+        const __m256i chroma_mask = _mm256_set1_epi32((1 << (LSB_PB - LSB_PR))
+                                                      - 1);
+        unsigned k = 0;
+        for (; k + 8 <= count; k += 8) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)
+                                               (fields->a + k));
+                __m256i b = _mm256_loadu_si256((const __m256i *)
+                                               (fields->b + k));
+                __m256i c = _mm256_loadu_si256((const __m256i *)
+                                               (fields->c + k));
+                __m256i d = _mm256_loadu_si256((const __m256i *)
+                                               (fields->d + k));
+                __m256i pb = _mm256_loadu_si256((const __m256i *)
+                                                (fields->pb_avg + k));
+                __m256i pr = _mm256_loadu_si256((const __m256i *)
+                                                (fields->pr_avg + k));
+
+                __m256i word = _mm256_slli_epi32(a, LSB_A);
+                word = _mm256_or_si256(word, _mm256_slli_epi32(
+                        _mm256_and_si256(b, signed_mask), LSB_B));
+                word = _mm256_or_si256(word, _mm256_slli_epi32(
+                        _mm256_and_si256(c, signed_mask), LSB_C));
+                word = _mm256_or_si256(word, _mm256_slli_epi32(
+                        _mm256_and_si256(d, signed_mask), LSB_D));
+                word = _mm256_or_si256(word, _mm256_slli_epi32(
+                        _mm256_and_si256(pb, chroma_mask), LSB_PB));
+                word = _mm256_or_si256(word, _mm256_and_si256(pr, 
+                                                              chroma_mask));
+                _mm256_storeu_si256((__m256i *)(words + k), word);
+        }
+        fields_to_words_scalar(fields, k, count, words);
+}
+#endif
+
 
 /************ DECOMPRESSION ************/
 
@@ -141,28 +311,27 @@ void unpacked_to_word(uint32_t* curr_word, unpacked_t curr_unpacked) {
 *       unpacked_pixmap containing a 2D array of structs type unpacked_t. 
 *
 *   
-*       In/Out Expectations: Expects a struct type word_pixmap. Mallocs
-*       memory for a struct unpacked_pixmap that the client must eventually 
-*       free. Returns this created type of unpacked_pixmap.  
+*       In/Out Expectations: Expects a struct type word_pixmap and an arena.
+*       Allocates the struct unpacked_pixmap in the arena, which frees it 
+*       when it is reset. Returns this created type of unpacked_pixmap.  
 */
-unpacked_pixmap word_to_unpacked_pixmap(word_pixmap old_word_pixmap) {
+unpacked_pixmap word_to_unpacked_pixmap(word_pixmap old_word_pixmap, 
+                                        Arena40_T arena) {
         assert(old_word_pixmap != NULL);
 
         int width = old_word_pixmap->width;
         int height = old_word_pixmap->height;
         
         unpacked_pixmap new_unpacked_pixmap = 
-                        malloc(sizeof(*new_unpacked_pixmap));
-        assert(new_unpacked_pixmap != NULL);
+                        Arena40_alloc(arena, sizeof(*new_unpacked_pixmap));
 
         new_unpacked_pixmap->width = width;
         new_unpacked_pixmap->height = height;
         new_unpacked_pixmap->methods = uarray2_methods_blocked;
         
         unpacked_t dummy_unpacked;
-        A2Methods_UArray2 pixmap = new_unpacked_pixmap->methods->
-                new_with_blocksize(width, height, sizeof(*dummy_unpacked), 
-                COMPRESSED_BLOCK_SIZE);
+        A2Methods_UArray2 pixmap = UArray2b_new_in(arena, width, height, 
+                sizeof(*dummy_unpacked), COMPRESSED_BLOCK_SIZE);
         new_unpacked_pixmap->pixels = pixmap;
         
         new_unpacked_pixmap->methods->map_block_major(new_unpacked_pixmap->
@@ -206,26 +375,204 @@ void word_to_unpacked(unpacked_t curr_unpacked, uint32_t* curr_word) {
         assert(curr_unpacked != NULL);
         assert(curr_word != NULL);
 
-        curr_unpacked->a = Bitpack_getu(*curr_word, (MAX_BITS - LSB_A), LSB_A);
-        curr_unpacked->b = Bitpack_gets(*curr_word, (LSB_A - LSB_B), LSB_B);
-        curr_unpacked->c = Bitpack_gets(*curr_word, (LSB_B - LSB_C), LSB_C);
-        curr_unpacked->d = Bitpack_gets(*curr_word, (LSB_C - LSB_D), LSB_D);
-        curr_unpacked->pb_avg = Bitpack_getu(*curr_word, 
+        standard_unpack(*curr_word, curr_unpacked);
+}
+
+/*
+*       Description: Generates the averages of a struct unpacked_t from a 
+*       word (uint32_t): a, the mean brightness of the block, and the 
+*       quantized pb_avg and pr_avg. b, c and d are not unpacked.
+*
+*       In/Out Expectations: expects to take a uint32_t, passed by 
+*       reference, and an instance of struct unpacked_t. Sets a, pb_avg and
+*       pr_avg from the word and b, c and d to 0. Returns void.
+*/
+void word_to_unpacked_averages(unpacked_t curr_unpacked, 
+                               uint32_t* curr_word) {
+        assert(curr_unpacked != NULL);
+        assert(curr_word != NULL);
+
+        curr_unpacked->a = Bitpack_getu_fixed(*curr_word, 
+                                        (MAX_BITS - LSB_A), LSB_A);
+        curr_unpacked->b = 0;
+        curr_unpacked->c = 0;
+        curr_unpacked->d = 0;
+        curr_unpacked->pb_avg = Bitpack_getu_fixed(*curr_word, 
                                         (LSB_D - LSB_PB), LSB_PB);
-        curr_unpacked->pr_avg = Bitpack_getu(*curr_word, 
+        curr_unpacked->pr_avg = Bitpack_getu_fixed(*curr_word, 
                                         (LSB_PB - LSB_PR), LSB_PR);
 }
 
 /*
-*       Description: Frees memory associated with a word_pixmap.
+*       Description: Unpacks the fields of count words into a structure of 
+*       arrays, with the widest vector instructions the CPU has. The fields
+*       are the ones word_to_unpacked unpacks.
 *
-*       In/Out Expectations: expects to take a word_pixmap that's been
-*       mallocked on the heap. Frees memory for the pointer and for 
-*       each element in the 2D array of pixels. Returns void.
+*       In/Out Expectations: expects an array of count words and a 
+*       word_fields whose arrays each have room for count fields, which are
+*       set. Returns void.
 */
-void free_word_pixmap(word_pixmap pixmap) {
-        assert(pixmap != NULL);
+void words_to_fields(const uint32_t *words, unsigned count, 
+                     word_fields fields) {
+        assert(fields != NULL);
+        assert(words != NULL || count == 0);
+
+        pthread_once(&field_functions_once, choose_field_functions);
+        unpack_words(words, count, fields);
+}
+
+/*
+*       Description: Unpacks the fields of the words [first, count) one 
+*       word at a time: the whole run on a CPU without vector instructions,
+*       or the words left over after the last full vector.
+*
+*       In/Out Expectations: expects an array of count words, the first 
+*       word to unpack, and a word_fields whose arrays each have room for 
+*       count fields. Returns void.
+*/
+void words_to_fields_scalar(const uint32_t *words, unsigned first, 
+                            unsigned count, word_fields fields) {
+        for (unsigned k = first; k < count; k++) {
+                uint32_t word = words[k];
+                fields->a[k] = Bitpack_getu_fixed(word, (MAX_BITS - LSB_A), 
+                                                  LSB_A);
+                fields->b[k] = Bitpack_gets_fixed(word, (LSB_A - LSB_B), 
+                                                  LSB_B);
+                fields->c[k] = Bitpack_gets_fixed(word, (LSB_B - LSB_C), 
+                                                  LSB_C);
+                fields->d[k] = Bitpack_gets_fixed(word, (LSB_C - LSB_D), 
+                                                  LSB_D);
+                fields->pb_avg[k] = Bitpack_getu_fixed(word, 
+                                        (LSB_D - LSB_PB), LSB_PB);
+                fields->pr_avg[k] = Bitpack_getu_fixed(word, 
+                                        (LSB_PB - LSB_PR), LSB_PR);
+        }
+}
+
+#if FIELDS_SIMD
+/*
+*       Description: Unpacks the fields of words 4 at a time with SSE2: the
+*       unsigned fields are shifted down and masked, and the signed ones 
+*       shifted up to the top of a lane and arithmetically back down, which
+*       extends their sign. The words left over are unpacked one at a time.
+*
+*       In/Out Expectations: like words_to_fields, on a CPU with SSE2. 
+*       Returns void.
+*/
+__attribute__((target("sse2")))
+void words_to_fields_sse2(const uint32_t *words, unsigned count, 
+                          word_fields fields) {
+        const __m128i chroma_mask = _mm_set1_epi32((1 << (LSB_PB - LSB_PR)) -
+                                                   1);
+        unsigned k = 0;
+        for (; k + 4 <= count; k += 4) {
+                __m128i word = _mm_loadu_si128((const __m128i *)(words + k));
+                _mm_storeu_si128((__m128i *)(fields->a + k), 
+                                 _mm_srli_epi32(word, LSB_A));
+                _mm_storeu_si128((__m128i *)(fields->b + k), 
+                                 _mm_srai_epi32(_mm_slli_epi32(word, 
+                                         MAX_BITS - LSB_A), 
+                                         MAX_BITS - (LSB_A - LSB_B)));
+                _mm_storeu_si128((__m128i *)(fields->c + k), 
+                                 _mm_srai_epi32(_mm_slli_epi32(word, 
+                                         MAX_BITS - LSB_B), 
+                                         MAX_BITS - (LSB_B - LSB_C)));
+                _mm_storeu_si128((__m128i *)(fields->d + k), 
+                                 _mm_srai_epi32(_mm_slli_epi32(word, 
+                                         MAX_BITS - LSB_C), 
+                                         MAX_BITS - (LSB_C - LSB_D)));
+                _mm_storeu_si128((__m128i *)(fields->pb_avg + k), 
+                                 _mm_and_si128(_mm_srli_epi32(word, LSB_PB),
+                                               chroma_mask));
+                _mm_storeu_si128((__m128i *)(fields->pr_avg + k), 
+                                 _mm_and_si128(word, chroma_mask));
+        }
+        words_to_fields_scalar(words, k, count, fields);
+}
+
+/*
+*       Description: Unpacks the fields of words 8 at a time with AVX2, the
+*       way words_to_fields_sse2 unpacks 4.
+*
+*       In/Out Expectations: like words_to_fields, on a CPU with AVX2. 
+*       Returns void.
+*/
+__attribute__((target("avx2")))
+void words_to_fields_avx2(const uint32_t *words, unsigned count, 
+                          word_fields fields) {
+        const __m256i chroma_mask = _mm256_set1_epi32((1 << (LSB_PB - LSB_PR))
+                                                      - 1);
+        unsigned k = 0;
+        for (; k + 8 <= count; k += 8) {
+                __m256i word = _mm256_loadu_si256((const __m256i *)
+                                                  (words + k));
+                _mm256_storeu_si256((__m256i *)(fields->a + k), 
+                                    _mm256_srli_epi32(word, LSB_A));
+                _mm256_storeu_si256((__m256i *)(fields->b + k), 
+                                    _mm256_srai_epi32(_mm256_slli_epi32(word,
+                                            MAX_BITS - LSB_A), 
+                                            MAX_BITS - (LSB_A - LSB_B)));
+                _mm256_storeu_si256((__m256i *)(fields->c + k), 
+                                    _mm256_srai_epi32(_mm256_slli_epi32(word,
+                                            MAX_BITS - LSB_B), 
+                                            MAX_BITS - (LSB_B - LSB_C)));
+                _mm256_storeu_si256((__m256i *)(fields->d + k), 
+                                    _mm256_srai_epi32(_mm256_slli_epi32(word,
+                                            MAX_BITS - LSB_C), 
+                                            MAX_BITS - (LSB_C - LSB_D)));
+                _mm256_storeu_si256((__m256i *)(fields->pb_avg + k), 
+                                    _mm256_and_si256(_mm256_srli_epi32(word, 
+                                            LSB_PB), chroma_mask));
+                _mm256_storeu_si256((__m256i *)(fields->pr_avg + k), 
+                                    _mm256_and_si256(word, chroma_mask));
+        }
+        words_to_fields_scalar(words, k, count, fields);
+}
+#endif
+
+/*
+*       Description: Chooses the batch functions for the CPU running the 
+*       codec: AVX2 if it has it, otherwise SSE2 if it has it, otherwise 
+*       the portable ones.
+*
+*       In/Out Expectations: Run once, by pthread_once. Returns void.
+*/
+void choose_field_functions(void) {
+#if FIELDS_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+                pack_fields = fields_to_words_avx2;
+                unpack_words = words_to_fields_avx2;
+                return;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+                pack_fields = fields_to_words_sse2;
+                unpack_words = words_to_fields_sse2;
+                return;
+        }
+#endif
+        pack_fields = fields_to_words_portable;
+        unpack_words = words_to_fields_portable;
+}
+
+/*
+*       Description: Packs count words from their fields one at a time, for
+*       a CPU without vector instructions.
+*
+*       In/Out Expectations: like fields_to_words. Returns void.
+*/
+void fields_to_words_portable(word_fields fields, unsigned count, 
+                              uint32_t *words) {
+        fields_to_words_scalar(fields, 0, count, words);
+}
 
-        pixmap->methods->free(&(pixmap->pixels));
-        free(pixmap);
-}
\ No newline at end of file
+/*
+*       Description: Unpacks the fields of count words one word at a time, 
+*       for a CPU without vector instructions.
+*
+*       In/Out Expectations: like words_to_fields. Returns void.
+*/
+void words_to_fields_portable(const uint32_t *words, unsigned count, 
+                              word_fields fields) {
+        words_to_fields_scalar(words, 0, count, fields);
+}
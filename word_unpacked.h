@@ -15,7 +15,9 @@
 #ifndef WORD_UNPACKED_
 #define WORD_UNPACKED_
 
+#include <stdint.h>
 #include <a2methods.h>
+#include "arena40.h"
 #include "bitpack.h"
 #include "unpacked_cv.h"
 
@@ -33,12 +35,32 @@ typedef struct word_pixmap {
     const struct A2Methods_T *methods;
 } *word_pixmap;
 
+/* 
+ * struct word_fields
+ *      A struct that holds the fields of a run of words as a structure of 
+ *      arrays, one array per field, the k-th element of each array being 
+ *      the field of the k-th word, so the fields of many words can be 
+ *      packed or unpacked at once with vector instructions.
+ */
+typedef struct word_fields {
+        uint32_t *a;
+        int32_t *b, *c, *d;
+        uint32_t *pb_avg, *pr_avg;
+} *word_fields;
+
 /********** COMPRESSION **********/
-word_pixmap unpacked_to_word_pixmap(unpacked_pixmap old_unpacked_pixmap);
+word_pixmap unpacked_to_word_pixmap(unpacked_pixmap old_unpacked_pixmap,
+                                    Arena40_T arena);
+void unpacked_to_word(uint32_t* curr_word, unpacked_t curr_unpacked);
+void fields_to_words(word_fields fields, unsigned count, uint32_t *words);
 
 /********** DECOMPRESSION **********/
-unpacked_pixmap word_to_unpacked_pixmap(word_pixmap old_word_pixmap);
-
-void free_word_pixmap(word_pixmap pixmap);
+unpacked_pixmap word_to_unpacked_pixmap(word_pixmap old_word_pixmap, 
+                                        Arena40_T arena);
+void word_to_unpacked(unpacked_t curr_unpacked, uint32_t* curr_word);
+void word_to_unpacked_averages(unpacked_t curr_unpacked, 
+                               uint32_t* curr_word);
+void words_to_fields(const uint32_t *words, unsigned count, 
+                     word_fields fields);
 
 #endif
\ No newline at end of file